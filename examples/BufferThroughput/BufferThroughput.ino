@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ESAT_CCSDSPacket.h>
+
+// ESAT_Buffer throughput example program.
+// Measure the speed of packet copies, both byte by byte (as done
+// through the single-byte Stream interface) and in bulk (as done
+// by ESAT_CCSDSPacket::copyTo()).
+
+// Copy packets of this packet data length.
+const unsigned long packetDataCapacity = 256;
+
+// Copy the packets this many times per measurement.
+const unsigned long copies = 1000;
+
+// Copy from this packet to the target packet.
+ESAT_CCSDSPacket source(packetDataCapacity);
+ESAT_CCSDSPacket target(packetDataCapacity);
+
+// Copy the source packet to the target packet byte by byte.
+void byteByByteCopy()
+{
+  target.writePrimaryHeader(source.readPrimaryHeader());
+  target.rewind();
+  source.rewind();
+  while (source.available() > 0)
+  {
+    (void) target.write(source.read());
+  }
+}
+
+// Copy the source packet to the target packet in bulk.
+void bulkCopy()
+{
+  (void) source.copyTo(target);
+}
+
+// Print the throughput of the copy function in bytes per second.
+void measure(const __FlashStringHelper* const name,
+             void (*copy)())
+{
+  const unsigned long start = micros();
+  for (unsigned long iteration = 0;
+       iteration < copies;
+       iteration = iteration + 1)
+  {
+    copy();
+  }
+  const unsigned long elapsedMicroseconds = micros() - start;
+  const float bytesPerSecond =
+    (1e6 * copies * source.packetDataLength()) / elapsedMicroseconds;
+  (void) Serial.print(name);
+  (void) Serial.print(F(": "));
+  (void) Serial.print(elapsedMicroseconds, DEC);
+  (void) Serial.print(F(" us, "));
+  (void) Serial.print(bytesPerSecond);
+  (void) Serial.println(F(" bytes/s"));
+}
+
+void setup()
+{
+  // Configure the Serial interface.
+  Serial.begin(9600);
+  // Wait until Serial is ready.
+  while (!Serial)
+  {
+  }
+  // Seed the random number generator.
+  randomSeed(0);
+  // Fill the source packet with random data.
+  source.writeTelemetryHeaders(0, 0, ESAT_Timestamp(), 0, 0, 0, 0);
+  while (source.packetDataLength() < source.capacity())
+  {
+    source.writeByte(random(0, 256));
+  }
+}
+
+void loop()
+{
+  (void) Serial.println(F("####################################"));
+  (void) Serial.println(F("Buffer throughput example program."));
+  (void) Serial.println(F("####################################"));
+  (void) Serial.print(F("Packet data length: "));
+  (void) Serial.println(source.packetDataLength(), DEC);
+  (void) Serial.print(F("Copies per measurement: "));
+  (void) Serial.println(copies, DEC);
+  measure(F("Byte-by-byte copy"), byteByByteCopy);
+  measure(F("Bulk copy"), bulkCopy);
+  // End.
+  (void) Serial.println(F("End."));
+  (void) Serial.println();
+  delay(1000);
+}
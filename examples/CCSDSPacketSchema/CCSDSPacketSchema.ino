@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ESAT_CCSDSPacketSchema.h>
+
+// ESAT_CCSDSPacketSchema example program.
+// Compile-time layouts of the user data field of packets.
+
+// Values of a housekeeping telemetry packet.
+struct Housekeeping
+{
+  word voltage;
+  int temperature;
+  float current;
+  boolean heaterOn;
+};
+
+// Layout of the housekeeping telemetry packet.
+typedef ESAT_CCSDSPacketSchema<Housekeeping,
+                               ESAT_CCSDS_FIELD(Housekeeping, voltage),
+                               ESAT_CCSDS_FIELD(Housekeeping, temperature),
+                               ESAT_CCSDS_FIELD(Housekeeping, current),
+                               ESAT_CCSDS_FIELD(Housekeeping, heaterOn)>
+  HousekeepingSchema;
+
+// Work with this packet, just big enough for the headers and the
+// housekeeping values.
+ESAT_StaticCCSDSPacket<ESAT_CCSDSSecondaryHeader::LENGTH
+                       + HousekeepingSchema::LENGTH> packet;
+
+// Print the housekeeping values.
+void printHousekeeping(const Housekeeping& housekeeping)
+{
+  (void) Serial.print(F("Voltage: "));
+  (void) Serial.println(housekeeping.voltage, DEC);
+  (void) Serial.print(F("Temperature: "));
+  (void) Serial.println(housekeeping.temperature, DEC);
+  (void) Serial.print(F("Current: "));
+  (void) Serial.println(housekeeping.current, 4);
+  (void) Serial.print(F("Heater on: "));
+  if (housekeeping.heaterOn)
+  {
+    (void) Serial.println(F("true"));
+  }
+  else
+  {
+    (void) Serial.println(F("false"));
+  }
+}
+
+void setup()
+{
+  // Configure the Serial interface.
+  Serial.begin(9600);
+  // Wait until Serial is ready.
+  while (!Serial)
+  {
+  }
+  // Seed the random number generator.
+  randomSeed(0);
+}
+
+void loop()
+{
+  (void) Serial.println(F("####################################"));
+  (void) Serial.println(F("CCSDS packet schema example program."));
+  (void) Serial.println(F("####################################"));
+  (void) Serial.print(F("Encoded length of the housekeeping values: "));
+  (void) Serial.println(HousekeepingSchema::LENGTH, DEC);
+  // Fill the packet.
+  Housekeeping housekeeping;
+  housekeeping.voltage = random(3000, 3600);
+  housekeeping.temperature = random(-40, 85);
+  housekeeping.current = random(0, 1000) / 1000.0;
+  housekeeping.heaterOn = (housekeeping.temperature < 0);
+  (void) Serial.println(F("Writing the housekeeping values:"));
+  printHousekeeping(housekeeping);
+  packet.writeTelemetryHeaders(1, 0, ESAT_Timestamp(), 1, 0, 0, 0);
+  (void) HousekeepingSchema::write(packet, housekeeping);
+  (void) Serial.print(F("Packet: "));
+  (void) Serial.println(packet);
+  // Read the packet back.
+  packet.rewind();
+  (void) packet.readSecondaryHeader();
+  Housekeeping readBack;
+  if (HousekeepingSchema::read(packet, readBack))
+  {
+    (void) Serial.println(F("Read the housekeeping values:"));
+    printHousekeeping(readBack);
+  }
+  else
+  {
+    (void) Serial.println(F("Error reading the housekeeping values."));
+  }
+  // End.
+  (void) Serial.println(F("End."));
+  (void) Serial.println();
+  delay(1000);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ESAT_CCSDSPacketQueue.h>
+#include <ESAT_CCSDSPacketToKISSFrameWriter.h>
+#include <ESAT_MemoryAccounting.h>
+
+// ESAT_MemoryAccounting example program.
+// Measure the dynamic memory held by some library objects.
+
+// Work with these objects.
+ESAT_CCSDSPacketQueue packetQueue;
+ESAT_CCSDSPacket packet;
+ESAT_CCSDSPacketToKISSFrameWriter writer;
+ESAT_Buffer output;
+
+// Print the statistics of a component.
+void printComponent(const __FlashStringHelper* const name,
+                    const ESAT_MemoryAccountingClass::Component component)
+{
+  (void) Serial.print(name);
+  (void) Serial.print(F(": "));
+  (void) Serial.print(ESAT_MemoryAccounting.liveBytes(component), DEC);
+  (void) Serial.print(F(" live bytes, "));
+  (void) Serial.print(ESAT_MemoryAccounting.peakBytes(component), DEC);
+  (void) Serial.print(F(" peak bytes, "));
+  (void) Serial.print(ESAT_MemoryAccounting.allocations(component), DEC);
+  (void) Serial.println(F(" allocations"));
+}
+
+void setup()
+{
+  // Configure the Serial interface.
+  Serial.begin(9600);
+  // Wait until Serial is ready.
+  while (!Serial)
+  {
+  }
+  // Start accounting before setting up the objects.
+  ESAT_MemoryAccounting.begin();
+  packetQueue = ESAT_CCSDSPacketQueue(4, 32);
+  packet = ESAT_CCSDSPacket(32);
+  output = ESAT_Buffer(128);
+  writer = ESAT_CCSDSPacketToKISSFrameWriter(output);
+}
+
+void loop()
+{
+  (void) Serial.println(F("#####################################"));
+  (void) Serial.println(F("Memory accounting example program."));
+  (void) Serial.println(F("#####################################"));
+  // Write a packet in a KISS frame, which takes a temporary buffer.
+  output.flush();
+  packet.writeTelemetryHeaders(0, 0, ESAT_Timestamp(), 0, 0, 0, 0);
+  (void) writer.bufferedWrite(packet);
+  printComponent(F("Buffer"), ESAT_MemoryAccounting.BUFFER);
+  printComponent(F("Packet queue"), ESAT_MemoryAccounting.PACKET_QUEUE);
+  printComponent(F("KISS stream"), ESAT_MemoryAccounting.KISS_STREAM);
+  (void) Serial.print(F("Total: "));
+  (void) Serial.print(ESAT_MemoryAccounting.totalLiveBytes(), DEC);
+  (void) Serial.println(F(" live bytes"));
+  // End.
+  (void) Serial.println(F("End."));
+  (void) Serial.println();
+  delay(1000);
+}
@@ -0,0 +1,463 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+// Host-side benchmarks of the packet pipeline of ESATUtil.
+// Measure the throughput and latency of the main packet operations
+// for several packet data lengths and print the results as
+// comma-separated values on the standard output, one row per
+// benchmark and packet data length.
+//
+// Usage: benchmarks [-n ITERATIONS] [PACKET_DATA_LENGTH...]
+
+#include <ESAT_Buffer.h>
+#include <ESAT_CCSDSPacket.h>
+#include <ESAT_CCSDSPacketQueue.h>
+#include <ESAT_CCSDSPacketToKISSFrameWriter.h>
+#include <ESAT_CCSDSPrimaryHeader.h>
+#include <ESAT_CCSDSTelecommandPacketDispatcher.h>
+#include <ESAT_CCSDSTelecommandPacketHandler.h>
+#include <ESAT_CCSDSTelemetryPacketBuilder.h>
+#include <ESAT_CCSDSTelemetryPacketContents.h>
+#include <ESAT_CRC16.h>
+#include <ESAT_CRC8.h>
+#include <ESAT_Clock.h>
+#include <ESAT_KISSFrameQueue.h>
+#include <ESAT_KISSStream.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// Default number of timed iterations of each benchmark.
+static const unsigned long DEFAULT_ITERATIONS = 20000;
+
+// Default packet data lengths.
+static const unsigned long DEFAULT_PACKET_DATA_LENGTHS[] = {
+  16, 64, 256, 1024,
+};
+
+// Number of individually timed iterations used for latency
+// percentiles.
+static const unsigned long LATENCY_SAMPLES = 1001;
+
+// Application process identifier of the benchmark packets.
+static const word APPLICATION_PROCESS_IDENTIFIER = 5;
+
+// Packet identifier of the benchmark packets.
+static const byte PACKET_IDENTIFIER = 3;
+
+// Monotonic clock used for timing.
+typedef std::chrono::steady_clock BenchmarkClock;
+
+// Clock with a constant time.
+class ConstantClock: public ESAT_Clock
+{
+  public:
+    ESAT_Timestamp read()
+    {
+      return ESAT_Timestamp(2021, 10, 21, 12, 0, 0);
+    }
+
+    void write(ESAT_Timestamp)
+    {
+    }
+};
+
+// Telecommand handler that accepts every packet.
+class AcceptingHandler: public ESAT_CCSDSTelecommandPacketHandler
+{
+  public:
+    boolean handleUserData(ESAT_CCSDSPacket)
+    {
+      return true;
+    }
+
+    byte packetIdentifier()
+    {
+      return PACKET_IDENTIFIER;
+    }
+
+    ESAT_SemanticVersionNumber versionNumber()
+    {
+      return ESAT_SemanticVersionNumber(1, 0, 0);
+    }
+};
+
+// Telemetry contents that fill the user data field with a constant
+// pattern of given length.
+class PatternContents: public ESAT_CCSDSTelemetryPacketContents
+{
+  public:
+    PatternContents(const std::vector<byte>& theUserData):
+      userData(theUserData)
+    {
+    }
+
+    boolean available()
+    {
+      return true;
+    }
+
+    boolean fillUserData(ESAT_CCSDSPacket& packet)
+    {
+      (void) packet.write(userData.data(), userData.size());
+      return true;
+    }
+
+    byte packetIdentifier()
+    {
+      return PACKET_IDENTIFIER;
+    }
+
+  private:
+    std::vector<byte> userData;
+};
+
+// Report benchmarks whose operation doesn't do what it should, as
+// their timings would be meaningless.
+static void check(const boolean condition,
+                  const char name[],
+                  const unsigned long packetDataLength)
+{
+  if (!condition)
+  {
+    (void) fprintf(stderr,
+                   "Benchmark %s failed with packet data length %lu.\n",
+                   name,
+                   packetDataLength);
+  }
+}
+
+// Return the nanoseconds between two instants.
+static double nanoseconds(const BenchmarkClock::time_point start,
+                          const BenchmarkClock::time_point end)
+{
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// Time the operation and print a row of results.
+// Each operation processes the given number of bytes.
+template<class Operation>
+static void measure(const char name[],
+                    const unsigned long packetDataLength,
+                    const unsigned long bytesPerOperation,
+                    const unsigned long iterations,
+                    Operation operation)
+{
+  // Warm up caches and branch predictors.
+  for (unsigned long i = 0; i < iterations / 10 + 1; i++)
+  {
+    operation();
+  }
+  // Throughput: time all iterations at once.
+  const BenchmarkClock::time_point start = BenchmarkClock::now();
+  for (unsigned long i = 0; i < iterations; i++)
+  {
+    operation();
+  }
+  const BenchmarkClock::time_point end = BenchmarkClock::now();
+  const double nanosecondsPerOperation =
+    nanoseconds(start, end) / iterations;
+  const double megabytesPerSecond =
+    (bytesPerOperation * 1e3) / nanosecondsPerOperation;
+  // Latency: time each iteration on its own.
+  std::vector<double> latencies(LATENCY_SAMPLES);
+  for (unsigned long i = 0; i < LATENCY_SAMPLES; i++)
+  {
+    const BenchmarkClock::time_point sampleStart = BenchmarkClock::now();
+    operation();
+    latencies[i] = nanoseconds(sampleStart, BenchmarkClock::now());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  (void) printf("%s,%lu,%lu,%.1f,%.2f,%.0f,%.0f\n",
+                name,
+                packetDataLength,
+                iterations,
+                nanosecondsPerOperation,
+                megabytesPerSecond,
+                latencies[LATENCY_SAMPLES / 2],
+                latencies[(LATENCY_SAMPLES * 99) / 100]);
+}
+
+// Run all benchmarks with the given packet data length.
+static void benchmark(const unsigned long packetDataLength,
+                      const unsigned long iterations)
+{
+  std::vector<byte> data(packetDataLength);
+  for (unsigned long i = 0; i < packetDataLength; i++)
+  {
+    data[i] = random(0, 256);
+  }
+  const unsigned long userDataLength =
+    packetDataLength - ESAT_CCSDSSecondaryHeader::LENGTH;
+  const std::vector<byte> userData(data.begin(),
+                                   data.begin() + userDataLength);
+  const unsigned long packetLength =
+    ESAT_CCSDSPrimaryHeader::LENGTH + packetDataLength;
+
+  // Primary header encode and decode.
+  ESAT_CCSDSPrimaryHeader primaryHeader;
+  primaryHeader.applicationProcessIdentifier = APPLICATION_PROCESS_IDENTIFIER;
+  primaryHeader.packetDataLength = packetDataLength;
+  byte primaryHeaderBytes[ESAT_CCSDSPrimaryHeader::LENGTH];
+  measure("primaryHeaderEncode", packetDataLength,
+          ESAT_CCSDSPrimaryHeader::LENGTH, iterations,
+          [&]()
+          {
+            primaryHeader.writeTo(primaryHeaderBytes);
+          });
+  measure("primaryHeaderEncodeToStream", packetDataLength,
+          ESAT_CCSDSPrimaryHeader::LENGTH, iterations,
+          [&]()
+          {
+            ESAT_Buffer output(primaryHeaderBytes,
+                               sizeof(primaryHeaderBytes));
+            (void) primaryHeader.writeTo(output);
+          });
+  measure("primaryHeaderDecode", packetDataLength,
+          ESAT_CCSDSPrimaryHeader::LENGTH, iterations,
+          [&]()
+          {
+            (void) primaryHeader.readFrom(primaryHeaderBytes);
+          });
+  volatile word routingKey;
+  measure("primaryHeaderPeek", packetDataLength,
+          ESAT_CCSDSPrimaryHeader::LENGTH, iterations,
+          [&]()
+          {
+            routingKey =
+              ESAT_CCSDSPrimaryHeader::peekApplicationProcessIdentifier(primaryHeaderBytes)
+              | (ESAT_CCSDSPrimaryHeader::peekPacketType(primaryHeaderBytes) << 11);
+          });
+
+  // Packet copies.
+  ESAT_CCSDSPacket telecommand(packetDataLength);
+  telecommand.writeTelecommandHeaders(APPLICATION_PROCESS_IDENTIFIER,
+                                      0,
+                                      ESAT_Timestamp(),
+                                      1, 0, 0,
+                                      PACKET_IDENTIFIER);
+  (void) telecommand.write(userData.data(), userData.size());
+  ESAT_CCSDSPacket target(packetDataLength);
+  check(telecommand.copyTo(target), "packetCopyTo", packetDataLength);
+  measure("packetCopyTo", packetDataLength, packetLength, iterations,
+          [&]()
+          {
+            (void) telecommand.copyTo(target);
+          });
+
+  // KISS frames.
+  const unsigned long frameCapacity =
+    ESAT_KISSStream::frameLength(packetDataLength);
+  std::vector<byte> frameBytes(frameCapacity);
+  ESAT_Buffer frame(frameBytes.data(), frameBytes.size());
+  ESAT_KISSStream encoder(frame, frameCapacity);
+  measure("kissEncode", packetDataLength, packetDataLength, iterations,
+          [&]()
+          {
+            frame.flush();
+            (void) encoder.beginFrame();
+            (void) encoder.write(data.data(), data.size());
+            (void) encoder.endFrame();
+          });
+  std::vector<byte> decodedBytes(packetDataLength);
+  ESAT_KISSStream decoder(frame, packetDataLength);
+  frame.rewind();
+  check(decoder.receiveFrame()
+        && (decoder.readBytes(decodedBytes.data(), decodedBytes.size())
+            == packetDataLength)
+        && (decodedBytes == data),
+        "kissDecode",
+        packetDataLength);
+  measure("kissDecode", packetDataLength, packetDataLength, iterations,
+          [&]()
+          {
+            frame.rewind();
+            (void) decoder.receiveFrame();
+            (void) decoder.readBytes(decodedBytes.data(),
+                                     decodedBytes.size());
+          });
+
+  // Buffered writes of packets in KISS frames.
+  const unsigned long packetFrameCapacity =
+    ESAT_KISSStream::frameLength(packetLength);
+  std::vector<byte> packetFrameBytes(packetFrameCapacity);
+  ESAT_Buffer packetFrame(packetFrameBytes.data(), packetFrameBytes.size());
+  ESAT_CCSDSPacketToKISSFrameWriter temporaryBufferWriter(packetFrame);
+  check(temporaryBufferWriter.bufferedWrite(telecommand),
+        "kissWriterTemporaryBuffer",
+        packetDataLength);
+  measure("kissWriterTemporaryBuffer", packetDataLength, packetLength,
+          iterations,
+          [&]()
+          {
+            packetFrame.flush();
+            (void) temporaryBufferWriter.bufferedWrite(telecommand);
+          });
+  ESAT_CCSDSPacketToKISSFrameWriter persistentBufferWriter(packetFrame,
+                                                           packetFrameCapacity);
+  packetFrame.flush();
+  check(persistentBufferWriter.bufferedWrite(telecommand),
+        "kissWriterPersistentBuffer",
+        packetDataLength);
+  measure("kissWriterPersistentBuffer", packetDataLength, packetLength,
+          iterations,
+          [&]()
+          {
+            packetFrame.flush();
+            (void) persistentBufferWriter.bufferedWrite(telecommand);
+          });
+
+  // Cyclic redundancy checks.
+  ESAT_CRC8 crc8(B00000111);
+  measure("crc8", packetDataLength, packetDataLength, iterations,
+          [&]()
+          {
+            (void) crc8.write(data.data(), data.size());
+            (void) crc8.read();
+          });
+  ESAT_CRC16 crc16;
+  measure("crc16", packetDataLength, packetDataLength, iterations,
+          [&]()
+          {
+            crc16.flush();
+            (void) crc16.write(data.data(), data.size());
+            (void) crc16.value();
+          });
+
+  // Packet queues.
+  ESAT_CCSDSPacketQueue queue(4, packetDataLength);
+  check(queue.write(telecommand) && queue.read(target),
+        "queueWriteRead",
+        packetDataLength);
+  measure("queueWriteRead", packetDataLength, 2 * packetLength, iterations,
+          [&]()
+          {
+            (void) queue.write(telecommand);
+            (void) queue.read(target);
+          });
+
+  // KISS frame queues.  A view of a queued frame must survive writes
+  // of other frames, even after they wrap around the memory arena.
+  ESAT_Buffer dataBuffer(data.data(), data.size(), data.size());
+  ESAT_KISSFrameQueue frameQueue((5 * packetDataLength) / 2, 4);
+  (void) frameQueue.write(dataBuffer);
+  (void) frameQueue.write(dataBuffer);
+  frameQueue.drop();
+  ESAT_BufferView queuedFrame = frameQueue.frame();
+  check(frameQueue.write(dataBuffer)
+        && (queuedFrame.readBytes(decodedBytes.data(), decodedBytes.size())
+            == packetDataLength)
+        && (decodedBytes == data)
+        && frameQueue.frame().readBytes(decodedBytes.data(),
+                                        decodedBytes.size())
+        && (decodedBytes == data),
+        "kissFrameQueueWriteRead",
+        packetDataLength);
+  frameQueue.flush();
+  measure("kissFrameQueueWriteRead", packetDataLength,
+          2 * packetDataLength, iterations,
+          [&]()
+          {
+            (void) frameQueue.write(dataBuffer);
+            ESAT_BufferView frameView = frameQueue.frame();
+            (void) frameView.readBytes(decodedBytes.data(),
+                                       decodedBytes.size());
+            frameQueue.drop();
+          });
+
+  // Telemetry packet builds.
+  ConstantClock clock;
+  PatternContents contents(userData);
+  ESAT_CCSDSTelemetryPacketBuilder builder(APPLICATION_PROCESS_IDENTIFIER,
+                                           1, 0, 0,
+                                           clock);
+  builder.add(contents);
+  check(builder.build(target, PACKET_IDENTIFIER),
+        "telemetryBuild",
+        packetDataLength);
+  measure("telemetryBuild", packetDataLength, packetLength, iterations,
+          [&]()
+          {
+            (void) builder.build(target, PACKET_IDENTIFIER);
+          });
+
+  // Telecommand packet dispatches.
+  AcceptingHandler handler;
+  ESAT_CCSDSTelecommandPacketDispatcher dispatcher(APPLICATION_PROCESS_IDENTIFIER);
+  dispatcher.add(handler);
+  check(dispatcher.dispatch(telecommand),
+        "telecommandDispatch",
+        packetDataLength);
+  measure("telecommandDispatch", packetDataLength, packetLength, iterations,
+          [&]()
+          {
+            (void) dispatcher.dispatch(telecommand);
+          });
+}
+
+int main(const int argc, char* argv[])
+{
+  unsigned long iterations = DEFAULT_ITERATIONS;
+  std::vector<unsigned long> packetDataLengths;
+  for (int i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+    {
+      i = i + 1;
+      iterations = strtoul(argv[i], nullptr, 10);
+    }
+    else
+    {
+      packetDataLengths.push_back(strtoul(argv[i], nullptr, 10));
+    }
+  }
+  if (packetDataLengths.empty())
+  {
+    packetDataLengths.assign(std::begin(DEFAULT_PACKET_DATA_LENGTHS),
+                             std::end(DEFAULT_PACKET_DATA_LENGTHS));
+  }
+  if (iterations == 0)
+  {
+    iterations = 1;
+  }
+  randomSeed(0);
+  (void) printf("benchmark,"
+                "packetDataLength,"
+                "iterations,"
+                "nanosecondsPerOperation,"
+                "megabytesPerSecond,"
+                "medianLatencyNanoseconds,"
+                "percentile99LatencyNanoseconds\n");
+  for (const unsigned long packetDataLength : packetDataLengths)
+  {
+    // Benchmark packets have a secondary header and packet data
+    // lengths go up to 65536.
+    if ((packetDataLength < ESAT_CCSDSSecondaryHeader::LENGTH)
+        || (packetDataLength > 65536))
+    {
+      (void) fprintf(stderr,
+                     "Skipping invalid packet data length %lu.\n",
+                     packetDataLength);
+      continue;
+    }
+    benchmark(packetDataLength, iterations);
+  }
+  return 0;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+#include <time.h>
+
+HardwareSerial Serial;
+
+TwoWire Wire;
+
+// Return the number of microseconds elapsed on the monotonic clock.
+static unsigned long long monotonicMicroseconds()
+{
+  timespec now;
+  (void) clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+void delay(const unsigned long milliseconds)
+{
+  delayMicroseconds(milliseconds * 1000);
+}
+
+void delayMicroseconds(const unsigned int microseconds)
+{
+  const unsigned long long start = monotonicMicroseconds();
+  while (monotonicMicroseconds() - start < microseconds)
+  {
+  }
+}
+
+void interrupts()
+{
+}
+
+unsigned long micros()
+{
+  return monotonicMicroseconds();
+}
+
+unsigned long millis()
+{
+  return monotonicMicroseconds() / 1000;
+}
+
+void noInterrupts()
+{
+}
+
+long random(const long maximum)
+{
+  return random(0, maximum);
+}
+
+long random(const long minimum, const long maximum)
+{
+  if (maximum <= minimum)
+  {
+    return minimum;
+  }
+  return minimum + rand() % (maximum - minimum);
+}
+
+void randomSeed(const unsigned long seed)
+{
+  srand(seed);
+}
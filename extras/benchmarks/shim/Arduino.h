@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+// Minimal host-side replacement of the Arduino core, just enough
+// to build ESATUtil on a POSIX system for benchmarking.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define B00 0
+#define B01 1
+#define B10 2
+#define B11 3
+#define B00000000 0x00
+#define B00000111 0x07
+#define B00001000 0x08
+#define B00010000 0x10
+#define B00111111 0x3F
+#define B01010000 0x50
+#define B11000000 0xC0
+#define B11100000 0xE0
+#define B11111111 0xFF
+
+#define highByte(w) ((uint8_t) ((w) >> 8))
+#define lowByte(w) ((uint8_t) ((w) & 0xFF))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitValue) \
+  ((bitValue) ? bitSet(value, bit) : bitClear(value, bit))
+
+template<class T, class L>
+auto min(const T& a, const L& b) -> decltype((b < a) ? b : a)
+{
+  return (b < a) ? b : a;
+}
+
+template<class T, class L>
+auto max(const T& a, const L& b) -> decltype((b < a) ? b : a)
+{
+  return (a < b) ? b : a;
+}
+
+inline word makeWord(uint16_t w)
+{
+  return w;
+}
+
+inline word makeWord(byte highByte, byte lowByte)
+{
+  return (word(highByte) << 8) | lowByte;
+}
+
+#define word(...) makeWord(__VA_ARGS__)
+
+class __FlashStringHelper;
+#define F(text) (reinterpret_cast<const __FlashStringHelper*>(text))
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t*) (address))
+#define pgm_read_word(address) (*(const uint16_t*) (address))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long milliseconds);
+void delayMicroseconds(unsigned int microseconds);
+void noInterrupts();
+void interrupts();
+long random(long maximum);
+long random(long minimum, long maximum);
+void randomSeed(unsigned long seed);
+
+class String
+{
+  public:
+    String(const char* text = "") : text(text) {}
+    String(char character) : text(1, character) {}
+    String(int number, unsigned char base = DEC)
+      : String(long(number), base) {}
+    String(unsigned int number, unsigned char base = DEC)
+      : String((unsigned long) number, base) {}
+    String(long number, unsigned char base = DEC)
+    {
+      char digits[40];
+      (void) snprintf(digits, sizeof(digits), (base == HEX) ? "%lx" : "%ld", number);
+      text = digits;
+    }
+    String(unsigned long number, unsigned char base = DEC)
+    {
+      char digits[40];
+      (void) snprintf(digits, sizeof(digits), (base == HEX) ? "%lx" : "%lu", number);
+      text = digits;
+    }
+    char charAt(unsigned int index) const { return text[index]; }
+    const char* c_str() const { return text.c_str(); }
+    unsigned int length() const { return text.size(); }
+    long toInt() const { return atol(text.c_str()); }
+    String operator+(const String& other) const { String sum; sum.text = text + other.text; return sum; }
+    String& operator+=(const String& other) { text += other.text; return *this; }
+    bool operator==(const String& other) const { return text == other.text; }
+
+  private:
+    std::string text;
+};
+
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+
+#endif /* Arduino_h */
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+#include "Arduino.h"
+
+// Serial port writing to the standard output.
+class HardwareSerial: public Stream
+{
+  public:
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    int peek() { return -1; }
+    int read() { return -1; }
+    size_t write(uint8_t datum) { return fwrite(&datum, 1, 1, stdout); }
+    size_t write(const uint8_t buffer[], size_t size) { return fwrite(buffer, 1, size, stdout); }
+    using Print::write;
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif /* HardwareSerial_h */
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef Print_h
+#define Print_h
+
+#include <stdio.h>
+#include <string.h>
+#include "Printable.h"
+
+// Byte sink with formatted printing, as in the Arduino core.
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+    virtual size_t write(uint8_t datum) = 0;
+    virtual size_t write(const uint8_t buffer[], size_t size)
+    {
+      // Count the bytes consumed, as escaping writers may write more
+      // than one byte per byte consumed.
+      size_t bytesConsumed = 0;
+      while ((bytesConsumed < size) && (write(buffer[bytesConsumed]) > 0))
+      {
+        bytesConsumed = bytesConsumed + 1;
+      }
+      return bytesConsumed;
+    }
+    size_t write(const char text[])
+    {
+      return (text == nullptr) ? 0 : write((const uint8_t*) text, strlen(text));
+    }
+    size_t write(const char buffer[], size_t size) { return write((const uint8_t*) buffer, size); }
+    size_t print(const __FlashStringHelper* text) { return write((const char*) text); }
+    size_t print(const String& text) { return write(text.c_str()); }
+    size_t print(const char text[]) { return write(text); }
+    size_t print(char character) { return write((uint8_t) character); }
+    size_t print(unsigned char number, int base = DEC) { return print((unsigned long) number, base); }
+    size_t print(int number, int base = DEC) { return print((long) number, base); }
+    size_t print(unsigned int number, int base = DEC) { return print((unsigned long) number, base); }
+    size_t print(long number, int base = DEC) { return print(String(number, base)); }
+    size_t print(unsigned long number, int base = DEC) { return print(String(number, base)); }
+    size_t print(double number, int digits = 2)
+    {
+      char text[64];
+      (void) snprintf(text, sizeof(text), "%.*f", digits, number);
+      return write(text);
+    }
+    size_t print(const Printable& printable) { return printable.printTo(*this); }
+    size_t println() { return write("\r\n"); }
+    template<class T> size_t println(const T& value)
+    {
+      const size_t bytesWritten = print(value);
+      return bytesWritten + println();
+    }
+    template<class T> size_t println(const T& value, int format)
+    {
+      const size_t bytesWritten = print(value, format);
+      return bytesWritten + println();
+    }
+};
+
+#endif /* Print_h */
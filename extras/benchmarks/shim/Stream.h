@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef Stream_h
+#define Stream_h
+
+#include "Arduino.h"
+
+// Byte source and sink, as in the Arduino core.
+// Reads never wait: there is nothing to wait for on the host.
+class Stream: public Print
+{
+  public:
+    virtual int available() = 0;
+    virtual int peek() = 0;
+    virtual int read() = 0;
+    unsigned long getTimeout() { return _timeout; }
+    size_t readBytes(char buffer[], size_t length)
+    {
+      size_t bytesRead = 0;
+      while (bytesRead < length)
+      {
+        const int datum = read();
+        if (datum < 0)
+        {
+          break;
+        }
+        buffer[bytesRead] = char(datum);
+        bytesRead = bytesRead + 1;
+      }
+      return bytesRead;
+    }
+    size_t readBytes(uint8_t buffer[], size_t length) { return readBytes((char*) buffer, length); }
+    String readString()
+    {
+      String text;
+      for (int datum = read(); datum >= 0; datum = read())
+      {
+        text += String(char(datum));
+      }
+      return text;
+    }
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+  protected:
+    unsigned long _timeout = 1000;
+    int timedPeek() { return peek(); }
+    int timedRead() { return read(); }
+};
+
+#endif /* Stream_h */
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef Wire_h
+#define Wire_h
+
+#include "Arduino.h"
+
+// I2C bus without devices: transmissions succeed and requests return
+// no data.
+class TwoWire: public Stream
+{
+  public:
+    void begin() {}
+    void begin(uint8_t) {}
+    void beginTransmission(uint8_t) {}
+    uint8_t endTransmission() { return 0; }
+    void onReceive(void (*)(int)) {}
+    void onRequest(void (*)()) {}
+    uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+    uint8_t requestFrom(int, int) { return 0; }
+    int available() { return 0; }
+    int peek() { return -1; }
+    int read() { return -1; }
+    size_t write(uint8_t) { return 1; }
+    using Print::write;
+};
+
+extern TwoWire Wire;
+
+#endif /* Wire_h */
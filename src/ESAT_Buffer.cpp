@@ -19,13 +19,17 @@
  */
 
 #include "ESAT_Buffer.h"
+#include "ESAT_MemoryAccounting.h"
 #include "ESAT_Util.h"
 
 ESAT_Buffer::ESAT_Buffer()
 {
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
   buffer = nullptr;
   bufferCapacity = 0;
   bytesInBuffer = 0;
+  dynamicallyAllocated = false;
+  pool = nullptr;
   readWritePosition = 0;
   references = nullptr;
   triedToReadBeyondBufferLength = false;
@@ -40,8 +44,44 @@ ESAT_Buffer::ESAT_Buffer(const unsigned long capacity)
   buffer = new byte[capacity];
   bufferCapacity = capacity;
   bytesInBuffer = 0;
+  dynamicallyAllocated = true;
+  pool = nullptr;
+  readWritePosition = 0;
+  references = new ESAT_ReferenceCount(1);
+  if ((buffer != nullptr) && (references != nullptr))
+  {
+    accountedComponent =
+      ESAT_MemoryAccounting.recordAllocation(allocationLength());
+  }
+  else
+  {
+    accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  }
+  triedToReadBeyondBufferLength = false;
+  triedToWriteBeyondBufferCapacity = false;
+  // Set the timeout for waiting for stream data to zero, as it
+  // doesn't make sense to wait when reading from these buffers.
+  setTimeout(0);
+}
+
+ESAT_Buffer::ESAT_Buffer(ESAT_BufferPool& thePool)
+{
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  buffer = thePool.allocate();
+  if (buffer == nullptr)
+  {
+    bufferCapacity = 0;
+    references = nullptr;
+  }
+  else
+  {
+    bufferCapacity = thePool.blockCapacity();
+    references = thePool.references(buffer);
+  }
+  bytesInBuffer = 0;
+  dynamicallyAllocated = true;
+  pool = &thePool;
   readWritePosition = 0;
-  references = new unsigned long(1);
   triedToReadBeyondBufferLength = false;
   triedToWriteBeyondBufferCapacity = false;
   // Set the timeout for waiting for stream data to zero, as it
@@ -53,9 +93,12 @@ ESAT_Buffer::ESAT_Buffer(byte array[],
                          const unsigned long capacity,
                          const unsigned long availableBytes)
 {
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
   buffer = array;
   bufferCapacity = capacity;
   bytesInBuffer = min(capacity, availableBytes);
+  dynamicallyAllocated = false;
+  pool = nullptr;
   readWritePosition = 0;
   references = nullptr;
   triedToReadBeyondBufferLength = false;
@@ -67,10 +110,12 @@ ESAT_Buffer::ESAT_Buffer(byte array[],
 
 ESAT_Buffer::ESAT_Buffer(const ESAT_Buffer& original)
 {
+  accountedComponent = original.accountedComponent;
   buffer = original.buffer;
   bufferCapacity = original.bufferCapacity;
   bytesInBuffer = original.bytesInBuffer;
   dynamicallyAllocated = original.dynamicallyAllocated;
+  pool = original.pool;
   readWritePosition = original.readWritePosition;
   references = original.references;
   triedToReadBeyondBufferLength = original.triedToReadBeyondBufferLength;
@@ -79,16 +124,38 @@ ESAT_Buffer::ESAT_Buffer(const ESAT_Buffer& original)
   addReference();
 }
 
+ESAT_Buffer::ESAT_Buffer(ESAT_Buffer&& original)
+{
+  accountedComponent = original.accountedComponent;
+  buffer = original.buffer;
+  bufferCapacity = original.bufferCapacity;
+  bytesInBuffer = original.bytesInBuffer;
+  dynamicallyAllocated = original.dynamicallyAllocated;
+  pool = original.pool;
+  readWritePosition = original.readWritePosition;
+  references = original.references;
+  triedToReadBeyondBufferLength = original.triedToReadBeyondBufferLength;
+  triedToWriteBeyondBufferCapacity = original.triedToWriteBeyondBufferCapacity;
+  _timeout = original._timeout;
+  // The reference held by the original buffer is now ours.
+  original.release();
+}
+
 ESAT_Buffer::~ESAT_Buffer()
 {
   removeReference();
 }
 
+unsigned long ESAT_Buffer::allocationLength() const
+{
+  return bufferCapacity + sizeof(ESAT_ReferenceCount);
+}
+
 void ESAT_Buffer::addReference()
 {
   if (references != nullptr)
   {
-    *references = *references + 1;
+    references->increment();
   }
 }
 
@@ -128,6 +195,55 @@ unsigned long ESAT_Buffer::length() const
   return bytesInBuffer;
 }
 
+boolean ESAT_Buffer::makeBackendMemoryPrivate(const unsigned long bytesToKeep)
+{
+  // Fall through when the backend memory is provided by the caller
+  // or it isn't shared with other buffers.
+  if (references == nullptr)
+  {
+    return true;
+  }
+  if (references->value() == 1)
+  {
+    return true;
+  }
+  // Normal operation: make a private copy of the shared backend
+  // memory (drawn from the same pool, if any) and drop our reference
+  // to the shared one.
+  byte* privateBuffer = nullptr;
+  ESAT_ReferenceCount* privateReferences = nullptr;
+  if (pool != nullptr)
+  {
+    privateBuffer = pool->allocate();
+    if (privateBuffer == nullptr)
+    {
+      return false;
+    }
+    privateReferences = pool->references(privateBuffer);
+  }
+  else
+  {
+    privateBuffer = new byte[bufferCapacity];
+    privateReferences = new ESAT_ReferenceCount(1);
+    if ((privateBuffer == nullptr) || (privateReferences == nullptr))
+    {
+      delete[] privateBuffer;
+      delete privateReferences;
+      return false;
+    }
+  }
+  (void) memcpy(privateBuffer, buffer, min(bytesToKeep, bufferCapacity));
+  removeReference();
+  buffer = privateBuffer;
+  references = privateReferences;
+  if (pool == nullptr)
+  {
+    accountedComponent =
+      ESAT_MemoryAccounting.recordAllocation(allocationLength());
+  }
+  return true;
+}
+
 int ESAT_Buffer::peek()
 {
   // Peeking past the last available byte returns -1.
@@ -140,6 +256,32 @@ int ESAT_Buffer::peek()
   return buffer[readWritePosition];
 }
 
+size_t ESAT_Buffer::peekBytes(byte peekBuffer[], const size_t bufferLength)
+{
+  // Fall through when no bytes are requested.
+  if (bufferLength == 0)
+  {
+    return 0;
+  }
+  // Peeking past the last available byte copies only the
+  // available bytes.
+  const unsigned long bytesToCopy =
+    min((unsigned long) bufferLength, availableBytes());
+  if (bytesToCopy < bufferLength)
+  {
+    triedToReadBeyondBufferLength = true;
+  }
+  else
+  {
+    triedToReadBeyondBufferLength = false;
+  }
+  if (bytesToCopy > 0)
+  {
+    (void) memcpy(peekBuffer, buffer + readWritePosition, bytesToCopy);
+  }
+  return bytesToCopy;
+}
+
 unsigned long ESAT_Buffer::position() const
 {
   return readWritePosition;
@@ -182,6 +324,18 @@ int ESAT_Buffer::read()
   return datum;
 }
 
+size_t ESAT_Buffer::readBytes(char readBuffer[], const size_t bufferLength)
+{
+  return readBytes((uint8_t*) readBuffer, bufferLength);
+}
+
+size_t ESAT_Buffer::readBytes(uint8_t readBuffer[], const size_t bufferLength)
+{
+  const size_t bytesRead = peekBytes(readBuffer, bufferLength);
+  readWritePosition = readWritePosition + bytesRead;
+  return bytesRead;
+}
+
 boolean ESAT_Buffer::readFrom(Stream& input, const unsigned long bytesToRead)
 {
   // As we flush the buffer first, we will lose the original state of
@@ -198,6 +352,12 @@ boolean ESAT_Buffer::readFrom(Stream& input, const unsigned long bytesToRead)
   {
     return true;
   }
+  // Just fail if we cannot get private backend memory.  We are
+  // going to overwrite everything, so there is nothing to keep.
+  if (!makeBackendMemoryPrivate(0))
+  {
+    return false;
+  }
   // Normal operation: read the required bytes from the input stream.
   bytesInBuffer = input.readBytes((char*) buffer, bytesToRead);
   if (bytesInBuffer == bytesToRead)
@@ -210,15 +370,35 @@ boolean ESAT_Buffer::readFrom(Stream& input, const unsigned long bytesToRead)
   }
 }
 
+void ESAT_Buffer::release()
+{
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  buffer = nullptr;
+  bufferCapacity = 0;
+  bytesInBuffer = 0;
+  dynamicallyAllocated = false;
+  pool = nullptr;
+  readWritePosition = 0;
+  references = nullptr;
+}
+
 void ESAT_Buffer::removeReference()
 {
   if (references != nullptr)
   {
-    *references = *references - 1;
-    if (*references == 0)
+    if (references->decrement() == 0)
     {
-      delete[] buffer;
-      delete references;
+      if (pool != nullptr)
+      {
+        pool->release(buffer);
+      }
+      else
+      {
+        delete[] buffer;
+        delete references;
+        ESAT_MemoryAccounting.recordDeallocation(accountedComponent,
+                                                 allocationLength());
+      }
     }
   }
 }
@@ -278,6 +458,14 @@ size_t ESAT_Buffer::write(const uint8_t datum)
     triedToWriteBeyondBufferCapacity = true;
     return 0;
   }
+  // Just fail if we cannot get private backend memory.  Everything
+  // past the read/write position is going to be discarded, so there
+  // is no need to keep it.
+  if (!makeBackendMemoryPrivate(readWritePosition))
+  {
+    triedToWriteBeyondBufferCapacity = true;
+    return 0;
+  }
   // Normal operation: write the datum to the current read/write
   // position of the backend buffer, increment the counters and return
   // the number of written bytes (1).
@@ -288,6 +476,53 @@ size_t ESAT_Buffer::write(const uint8_t datum)
   return 1;
 }
 
+size_t ESAT_Buffer::write(const uint8_t* const writeBuffer,
+                          const size_t bufferLength)
+{
+  // Fall through when there is nothing to write.
+  if (bufferLength == 0)
+  {
+    return 0;
+  }
+  // Just fail if we have no backend buffer.
+  if (!buffer)
+  {
+    triedToWriteBeyondBufferCapacity = true;
+    return 0;
+  }
+  // Just fail if we are above capacity.
+  if (readWritePosition >= bufferCapacity)
+  {
+    triedToWriteBeyondBufferCapacity = true;
+    return 0;
+  }
+  // Just fail if we cannot get private backend memory.  Everything
+  // past the read/write position is going to be discarded, so there
+  // is no need to keep it.
+  if (!makeBackendMemoryPrivate(readWritePosition))
+  {
+    triedToWriteBeyondBufferCapacity = true;
+    return 0;
+  }
+  // Normal operation: copy as many bytes as fit from the current
+  // read/write position of the backend buffer, update the counters
+  // and return the number of written bytes.
+  const unsigned long bytesToCopy =
+    min((unsigned long) bufferLength, bufferCapacity - readWritePosition);
+  if (bytesToCopy < bufferLength)
+  {
+    triedToWriteBeyondBufferCapacity = true;
+  }
+  else
+  {
+    triedToWriteBeyondBufferCapacity = false;
+  }
+  (void) memcpy(buffer + readWritePosition, writeBuffer, bytesToCopy);
+  readWritePosition = readWritePosition + bytesToCopy;
+  bytesInBuffer = readWritePosition;
+  return bytesToCopy;
+}
+
 boolean ESAT_Buffer::writeTo(Stream& output) const
 {
   // Just fail if we have no backend buffer.
@@ -317,10 +552,12 @@ ESAT_Buffer& ESAT_Buffer::operator=(const ESAT_Buffer& original)
   if (this != &original)
   {
     removeReference();
+    accountedComponent = original.accountedComponent;
     buffer = original.buffer;
     bufferCapacity = original.bufferCapacity;
     bytesInBuffer = original.bytesInBuffer;
     dynamicallyAllocated = original.dynamicallyAllocated;
+    pool = original.pool;
     readWritePosition = original.readWritePosition;
     references = original.references;
     triedToReadBeyondBufferLength = original.triedToReadBeyondBufferLength;
@@ -330,3 +567,25 @@ ESAT_Buffer& ESAT_Buffer::operator=(const ESAT_Buffer& original)
   }
   return *this;
 }
+
+ESAT_Buffer& ESAT_Buffer::operator=(ESAT_Buffer&& original)
+{
+  if (this != &original)
+  {
+    removeReference();
+    accountedComponent = original.accountedComponent;
+    buffer = original.buffer;
+    bufferCapacity = original.bufferCapacity;
+    bytesInBuffer = original.bytesInBuffer;
+    dynamicallyAllocated = original.dynamicallyAllocated;
+    pool = original.pool;
+    readWritePosition = original.readWritePosition;
+    references = original.references;
+    triedToReadBeyondBufferLength = original.triedToReadBeyondBufferLength;
+    triedToWriteBeyondBufferCapacity = original.triedToWriteBeyondBufferCapacity;
+    _timeout = original._timeout;
+    // The reference held by the original buffer is now ours.
+    original.release();
+  }
+  return *this;
+}
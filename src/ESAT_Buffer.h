@@ -23,9 +23,19 @@
 
 #include <Arduino.h>
 #include <Stream.h>
+#include "ESAT_BufferPool.h"
 
 // Stream interface to a byte buffer with bounds checking:
 // writes and reads will never go beyond the buffer limits.
+// Buffers that allocate their own memory share it between copies
+// until one of the copies writes to it: only then does the writing
+// copy get its own private backend memory (copy-on-write).
+// Buffers backed by a byte array provided by the caller always
+// share that array between copies.
+// The reference count of shared backend memory is interrupt-safe,
+// so copies of a buffer can be created and destroyed both from
+// interrupt handlers and from the main loop.  Each buffer object
+// must still be used from just one of them at a time.
 class ESAT_Buffer: public Printable, public Stream
 {
   public:
@@ -37,6 +47,13 @@ class ESAT_Buffer: public Printable, public Stream
     // The buffer will allocate its own memory.
     ESAT_Buffer(unsigned long capacity);
 
+    // Instantiate a buffer backed by a block drawn from a pool.
+    // The capacity of the buffer is the block capacity of the pool,
+    // or 0 when the pool has no free blocks.
+    // The block goes back to the pool when the last buffer using it
+    // is destroyed.
+    ESAT_Buffer(ESAT_BufferPool& pool);
+
     // Instantiate a buffer backed by a byte array of given capacity.
     // The number of available bytes (with a default value of 0 when
     // not provided) is the number of bytes that can be read as soon
@@ -52,8 +69,18 @@ class ESAT_Buffer: public Printable, public Stream
 
     // Copy constructor.
     // Instantiate a buffer with the same backend memory as another buffer.
+    // If the buffer manages its own memory, the first write to either
+    // buffer will give the writing buffer a private copy of the
+    // backend memory.
     ESAT_Buffer(const ESAT_Buffer& original);
 
+    // Move constructor.
+    // Instantiate a buffer that takes over the backend memory of
+    // another buffer, which is left empty.
+    // Unlike the copy constructor, this doesn't touch the reference
+    // count.
+    ESAT_Buffer(ESAT_Buffer&& original);
+
     // Destroy a buffer.
     ~ESAT_Buffer();
 
@@ -79,6 +106,12 @@ class ESAT_Buffer: public Printable, public Stream
     // without advancing to the next one.
     int peek();
 
+    // Copy up to bufferLength bytes (bounded by the number of unread
+    // bytes) to a byte buffer without advancing the read/write
+    // position.
+    // Return the number of bytes copied.
+    size_t peekBytes(byte buffer[], size_t bufferLength);
+
     // Return the read/write position.
     unsigned long position() const;
 
@@ -91,6 +124,18 @@ class ESAT_Buffer: public Printable, public Stream
     // of bytes stored in the buffer as returned by length().
     int read();
 
+    // Read up to bufferLength bytes (bounded by the number of unread
+    // bytes) into a byte buffer in one bulk copy.
+    // Advance the read/write position by the number of bytes read.
+    // Return the number of bytes read.
+    size_t readBytes(char buffer[], size_t bufferLength);
+
+    // Read up to bufferLength bytes (bounded by the number of unread
+    // bytes) into a byte buffer in one bulk copy.
+    // Advance the read/write position by the number of bytes read.
+    // Return the number of bytes read.
+    size_t readBytes(uint8_t buffer[], size_t bufferLength);
+
     // Read a number of bytes from an input stream and fill the
     // buffer from the start with them.
     // Return true on success; otherwise return false.
@@ -130,9 +175,13 @@ class ESAT_Buffer: public Printable, public Stream
     // Advance the read/write position by 1, bounded by the capacity.
     size_t write(uint8_t datum);
 
-    // Import size_t Print::write(const uint8_t* buffer, size_t bufferLength).
-    // Write a byte buffer of given length.
-    // Return the number of bytes written.
+    // Write a byte buffer of given length in one bulk copy, bounded
+    // by the capacity.
+    // Return the actual number of bytes written.
+    // Advance the read/write position by the number of bytes written.
+    size_t write(const uint8_t* buffer, size_t bufferLength);
+
+    // Import the rest of the Print::write() overloads.
     using Print::write;
 
     // Write the contents of the buffer to an output stream.
@@ -141,9 +190,28 @@ class ESAT_Buffer: public Printable, public Stream
 
     // Assignment operator: make this buffer have the same backend
     // memory as another buffer.
+    // If the buffer manages its own memory, the first write to either
+    // buffer will give the writing buffer a private copy of the
+    // backend memory.
     ESAT_Buffer& operator=(const ESAT_Buffer& original);
 
+    // Move assignment operator: make this buffer take over the
+    // backend memory of another buffer, which is left empty.
+    // Unlike the copy assignment operator, this doesn't touch the
+    // reference count of the other buffer.
+    ESAT_Buffer& operator=(ESAT_Buffer&& original);
+
   private:
+    // Buffer chains and buffer views access the backend buffer
+    // directly.
+    friend class ESAT_BufferChain;
+    friend class ESAT_BufferView;
+
+    // Memory accounting component charged for the backend buffer
+    // (ESAT_MemoryAccountingClass::UNACCOUNTED when it isn't
+    // accounted for).
+    byte accountedComponent;
+
     // Backend buffer.
     byte* buffer;
 
@@ -156,12 +224,19 @@ class ESAT_Buffer: public Printable, public Stream
     // True when the backend buffer was allocated dynamically.
     boolean dynamicallyAllocated;
 
+    // Pool the backend buffer was drawn from
+    // (nullptr when it comes from the heap or from the caller).
+    ESAT_BufferPool* pool;
+
     // Position of the next read or write operation.
     unsigned long readWritePosition;
 
     // Reference count.
     // Used only when the buffer manages its own memory.
-    unsigned long* references;
+    // When the backend buffer comes from a pool, the reference count
+    // is stored in the header of the pool block.
+    // Updates to the reference count are atomic.
+    ESAT_ReferenceCount* references;
 
     // Set to true if the last read() or peek() attempt was beyond
     // the length() of the buffer; otherwise set to false.
@@ -175,9 +250,26 @@ class ESAT_Buffer: public Printable, public Stream
     // to the reference count.
     void addReference();
 
+    // Return the number of bytes of heap memory taken by a backend
+    // buffer allocated by the buffer itself, including its reference
+    // count.
+    unsigned long allocationLength() const;
+
+    // If the buffer manages its own backend memory and shares it with
+    // other buffers, replace it with a private copy of the first
+    // bytesToKeep bytes.  This is the copy part of copy-on-write.
+    // Return true on success; otherwise (when the private copy can't
+    // be allocated) return false.
+    boolean makeBackendMemoryPrivate(unsigned long bytesToKeep);
+
+    // Leave this buffer empty, without backend memory, and without
+    // touching the reference count.
+    void release();
+
     // If the buffer manages its own backend memory, remove a
     // reference from the reference count.  If the reference count
-    // goes to zero, free the backend buffer.
+    // goes to zero, free the backend buffer (or give it back to
+    // its pool).
     void removeReference();
 };
 
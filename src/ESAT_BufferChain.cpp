@@ -0,0 +1,367 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_BufferChain.h"
+#include "ESAT_Util.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <sys/uio.h>
+#endif
+
+ESAT_BufferChain::ESAT_BufferChain()
+{
+  bufferCount = 0;
+  inlineStorageLength = 0;
+  positionInSegment = 0;
+  segmentIndex = 0;
+  segmentCount = 0;
+  // Set the timeout for waiting for stream data to zero, as it
+  // doesn't make sense to wait when reading from these chains.
+  setTimeout(0);
+}
+
+boolean ESAT_BufferChain::append(const byte array[],
+                                 const unsigned long arrayLength)
+{
+  // Fall through on empty segments.
+  if (arrayLength == 0)
+  {
+    return true;
+  }
+  // Just fail if there is no room for more segments.
+  if (segmentCount >= MAXIMUM_SEGMENTS)
+  {
+    return false;
+  }
+  // Normal operation: link the array.
+  segmentList[segmentCount].start = array;
+  segmentList[segmentCount].inlineOffset = 0;
+  segmentList[segmentCount].length = arrayLength;
+  segmentCount = segmentCount + 1;
+  return true;
+}
+
+boolean ESAT_BufferChain::append(const ESAT_Buffer& buffer)
+{
+  return append(buffer, buffer.buffer, buffer.length());
+}
+
+boolean ESAT_BufferChain::append(const ESAT_Buffer& buffer,
+                                 const byte array[],
+                                 const unsigned long arrayLength)
+{
+  // Fall through on empty segments.
+  if (arrayLength == 0)
+  {
+    return true;
+  }
+  // Just fail if there is no room for more segments or for more
+  // references to buffers.
+  if (segmentCount >= MAXIMUM_SEGMENTS)
+  {
+    return false;
+  }
+  if (!holdReference(buffer))
+  {
+    return false;
+  }
+  // Normal operation: link the array.
+  return append(array, arrayLength);
+}
+
+boolean ESAT_BufferChain::append(const ESAT_BufferView& view)
+{
+  return append(view.backendBuffer, view.start(), view.length());
+}
+
+boolean ESAT_BufferChain::appendCopy(const byte array[],
+                                     const unsigned long arrayLength)
+{
+  // Fall through on empty segments.
+  if (arrayLength == 0)
+  {
+    return true;
+  }
+  // Just fail if there is no room for more segments or for the
+  // contents of the array.
+  if (segmentCount >= MAXIMUM_SEGMENTS)
+  {
+    return false;
+  }
+  if (arrayLength > (unsigned long) (INLINE_CAPACITY - inlineStorageLength))
+  {
+    return false;
+  }
+  // Normal operation: copy the array to the inline storage and link
+  // the copy.
+  (void) memcpy(inlineStorage + inlineStorageLength, array, arrayLength);
+  segmentList[segmentCount].start = nullptr;
+  segmentList[segmentCount].inlineOffset = inlineStorageLength;
+  segmentList[segmentCount].length = arrayLength;
+  segmentCount = segmentCount + 1;
+  inlineStorageLength = inlineStorageLength + arrayLength;
+  return true;
+}
+
+int ESAT_BufferChain::available()
+{
+  // Truncate the result of availableBytes() to fit a 16-bit signed
+  // integer.
+  return min(availableBytes(), (unsigned long) 0x7FFF);
+}
+
+unsigned long ESAT_BufferChain::availableBytes() const
+{
+  return length() - position();
+}
+
+void ESAT_BufferChain::flush()
+{
+  for (byte index = 0; index < bufferCount; index = index + 1)
+  {
+    buffers[index] = ESAT_Buffer();
+  }
+  bufferCount = 0;
+  inlineStorageLength = 0;
+  positionInSegment = 0;
+  segmentIndex = 0;
+  segmentCount = 0;
+}
+
+boolean ESAT_BufferChain::holdReference(const ESAT_Buffer& buffer)
+{
+  // Fall through when the chain already holds a reference to the
+  // memory of the buffer.
+  for (byte index = 0; index < bufferCount; index = index + 1)
+  {
+    if (buffers[index].buffer == buffer.buffer)
+    {
+      return true;
+    }
+  }
+  // Just fail if there is no room for more references.
+  if (bufferCount >= MAXIMUM_BUFFERS)
+  {
+    return false;
+  }
+  // Normal operation: share the memory of the buffer.
+  buffers[bufferCount] = buffer;
+  bufferCount = bufferCount + 1;
+  return true;
+}
+
+unsigned long ESAT_BufferChain::length() const
+{
+  unsigned long totalLength = 0;
+  for (byte index = 0; index < segmentCount; index = index + 1)
+  {
+    totalLength = totalLength + segmentList[index].length;
+  }
+  return totalLength;
+}
+
+int ESAT_BufferChain::peek()
+{
+  // Peeking past the last segment returns -1.
+  if (segmentIndex >= segmentCount)
+  {
+    return -1;
+  }
+  return segment(segmentIndex)[positionInSegment];
+}
+
+unsigned long ESAT_BufferChain::position() const
+{
+  unsigned long currentPosition = positionInSegment;
+  for (byte index = 0; index < segmentIndex; index = index + 1)
+  {
+    currentPosition = currentPosition + segmentList[index].length;
+  }
+  return currentPosition;
+}
+
+size_t ESAT_BufferChain::printTo(Print& output) const
+{
+  size_t bytesWritten = 0;
+  for (byte index = 0; index < segmentCount; index = index + 1)
+  {
+    const byte* const start = segment(index);
+    for (unsigned long i = 0; i < segmentList[index].length; i++)
+    {
+      if (bytesWritten == 0)
+      {
+        bytesWritten =
+          bytesWritten
+          + output.print(F("0x"));
+      }
+      else
+      {
+        bytesWritten =
+          bytesWritten
+          + output.print(F(", 0x"));
+      }
+      bytesWritten =
+        bytesWritten
+        + output.print(ESAT_Util.byteToHexadecimal(start[i]));
+    }
+  }
+  return bytesWritten;
+}
+
+int ESAT_BufferChain::read()
+{
+  const int datum = peek();
+  // Advance the read position only when there is a byte available.
+  if (datum > -1)
+  {
+    positionInSegment = positionInSegment + 1;
+    if (positionInSegment >= segmentList[segmentIndex].length)
+    {
+      positionInSegment = 0;
+      segmentIndex = segmentIndex + 1;
+    }
+  }
+  return datum;
+}
+
+size_t ESAT_BufferChain::readBytes(char buffer[], const size_t bufferLength)
+{
+  return readBytes((uint8_t*) buffer, bufferLength);
+}
+
+size_t ESAT_BufferChain::readBytes(uint8_t buffer[], const size_t bufferLength)
+{
+  size_t bytesRead = 0;
+  while ((bytesRead < bufferLength) && (segmentIndex < segmentCount))
+  {
+    const unsigned long bytesToCopy =
+      min((unsigned long) (bufferLength - bytesRead),
+          segmentList[segmentIndex].length - positionInSegment);
+    (void) memcpy(buffer + bytesRead,
+                  segment(segmentIndex) + positionInSegment,
+                  bytesToCopy);
+    bytesRead = bytesRead + bytesToCopy;
+    positionInSegment = positionInSegment + bytesToCopy;
+    if (positionInSegment >= segmentList[segmentIndex].length)
+    {
+      positionInSegment = 0;
+      segmentIndex = segmentIndex + 1;
+    }
+  }
+  return bytesRead;
+}
+
+void ESAT_BufferChain::rewind()
+{
+  positionInSegment = 0;
+  segmentIndex = 0;
+}
+
+const byte* ESAT_BufferChain::segment(const byte index) const
+{
+  if (index >= segmentCount)
+  {
+    return nullptr;
+  }
+  if (segmentList[index].start == nullptr)
+  {
+    return inlineStorage + segmentList[index].inlineOffset;
+  }
+  return segmentList[index].start;
+}
+
+unsigned long ESAT_BufferChain::segmentLength(const byte index) const
+{
+  if (index >= segmentCount)
+  {
+    return 0;
+  }
+  return segmentList[index].length;
+}
+
+byte ESAT_BufferChain::segments() const
+{
+  return segmentCount;
+}
+
+size_t ESAT_BufferChain::write(const uint8_t datum)
+{
+  (void) datum;
+  return 0;
+}
+
+boolean ESAT_BufferChain::writeTo(Stream& output) const
+{
+  for (byte index = 0; index < segmentCount; index = index + 1)
+  {
+    const size_t bytesWritten =
+      output.write(segment(index), segmentList[index].length);
+    if (bytesWritten < segmentList[index].length)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+#ifdef __linux__
+boolean ESAT_BufferChain::writeTo(const int fileDescriptor) const
+{
+  struct iovec vectors[MAXIMUM_SEGMENTS];
+  for (byte index = 0; index < segmentCount; index = index + 1)
+  {
+    vectors[index].iov_base = (void*) segment(index);
+    vectors[index].iov_len = segmentList[index].length;
+  }
+  // Normally, a single call will write everything; after partial
+  // writes, skip the bytes already written and try again.
+  byte firstVector = 0;
+  while (firstVector < segmentCount)
+  {
+    const ssize_t bytesWritten = writev(fileDescriptor,
+                                        vectors + firstVector,
+                                        segmentCount - firstVector);
+    if ((bytesWritten < 0) && (errno == EINTR))
+    {
+      continue;
+    }
+    if (bytesWritten <= 0)
+    {
+      return false;
+    }
+    size_t remainingBytes = bytesWritten;
+    while ((firstVector < segmentCount)
+           && (remainingBytes >= vectors[firstVector].iov_len))
+    {
+      remainingBytes = remainingBytes - vectors[firstVector].iov_len;
+      firstVector = firstVector + 1;
+    }
+    if (firstVector < segmentCount)
+    {
+      vectors[firstVector].iov_base =
+        ((byte*) vectors[firstVector].iov_base) + remainingBytes;
+      vectors[firstVector].iov_len =
+        vectors[firstVector].iov_len - remainingBytes;
+    }
+  }
+  return true;
+}
+#endif
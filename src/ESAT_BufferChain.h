@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_BufferChain_h
+#define ESAT_BufferChain_h
+
+#include <Arduino.h>
+#include <Stream.h>
+#include "ESAT_Buffer.h"
+#include "ESAT_BufferView.h"
+
+// Stream interface to a chain of byte array segments that reads as
+// one logical byte sequence (scatter/gather input/output).
+// Buffer chains link the pieces of a message (for example, the
+// primary header, the secondary header and the user data of a
+// packet) without concatenating them into one contiguous buffer, so
+// writers and encoders can consume the whole message at once while
+// each piece stays where it is.
+// Segments of byte arrays don't own their memory: the array must
+// stay alive and unmodified while the chain is in use.  Segments of
+// buffers and buffer views hold a reference to the backend memory of
+// the buffer instead, so that memory stays alive for as long as the
+// chain exists, and writes to the buffer go to a private copy
+// (copy-on-write) and leave the chain untouched.  (Buffers backed by
+// an array of the caller still need the array to stay alive and
+// unmodified.)  Short segments (like headers) can be copied into the
+// inline storage of the chain.
+// Buffer chains are read-only: writes fail.
+class ESAT_BufferChain: public Printable, public Stream
+{
+  public:
+    // Number of bytes of inline storage for copied segments.
+    static const byte INLINE_CAPACITY = 16;
+
+    // Maximum number of distinct buffers the segments of a chain can
+    // hold references to.
+    static const byte MAXIMUM_BUFFERS = 2;
+
+    // Maximum number of segments of a chain.
+    static const byte MAXIMUM_SEGMENTS = 8;
+
+    // Instantiate an empty buffer chain.
+    ESAT_BufferChain();
+
+    // Append a segment with the contents of a byte array of given
+    // length.  The segment refers to the array, which must stay alive
+    // and unmodified while the chain is in use.
+    // Empty segments are ignored.
+    // Return true on success; otherwise (when the chain has no room
+    // for more segments) return false.
+    boolean append(const byte array[], unsigned long arrayLength);
+
+    // Append a segment with the contents of a buffer, from its start
+    // to its length().  The segment refers to the backend memory of
+    // the buffer and holds a reference to it.
+    // Empty segments are ignored.
+    // Return true on success; otherwise (when the chain has no room
+    // for more segments or already holds references to
+    // MAXIMUM_BUFFERS other buffers) return false.
+    boolean append(const ESAT_Buffer& buffer);
+
+    // Append a segment with the contents of the window of a buffer
+    // view.  The segment refers to the backend memory of the view and
+    // holds a reference to it.
+    // Empty segments are ignored.
+    // Return true on success; otherwise (when the chain has no room
+    // for more segments or already holds references to
+    // MAXIMUM_BUFFERS other buffers) return false.
+    boolean append(const ESAT_BufferView& view);
+
+    // Append a segment with a copy of the contents of a byte array of
+    // given length.  The copy goes to the inline storage of the chain,
+    // so the array can be discarded afterwards.
+    // Empty segments are ignored.
+    // Return true on success; otherwise (when the chain has no room
+    // for more segments or not enough inline storage) return false.
+    boolean appendCopy(const byte array[], unsigned long arrayLength);
+
+    // Return the number of unread bytes, truncated to an int.
+    int available();
+
+    // Return the number of unread bytes.
+    unsigned long availableBytes() const;
+
+    // Remove all the segments and release the references to the
+    // memory of buffers.
+    void flush();
+
+    // Return the total number of bytes of all the segments.
+    unsigned long length() const;
+
+    // Return the next byte (or -1 if no byte could be read)
+    // without advancing to the next one.
+    int peek();
+
+    // Return the read position.
+    unsigned long position() const;
+
+    // Print the contents of the chain in human readable form to an
+    // output stream.
+    size_t printTo(Print& output) const;
+
+    // Return the next byte (or -1 if no byte could be read).
+    // Advance the read position by 1, bounded by the length.
+    int read();
+
+    // Read up to bufferLength bytes (bounded by the number of unread
+    // bytes) into a byte buffer in one bulk copy per segment.
+    // Advance the read position by the number of bytes read.
+    // Return the number of bytes read.
+    size_t readBytes(char buffer[], size_t bufferLength);
+
+    // Read up to bufferLength bytes (bounded by the number of unread
+    // bytes) into a byte buffer in one bulk copy per segment.
+    // Advance the read position by the number of bytes read.
+    // Return the number of bytes read.
+    size_t readBytes(uint8_t buffer[], size_t bufferLength);
+
+    // Set the read position to the start of the chain.
+    void rewind();
+
+    // Return the start of a segment (or nullptr if there is no such
+    // segment).
+    const byte* segment(byte index) const;
+
+    // Return the length of a segment (or 0 if there is no such
+    // segment).
+    unsigned long segmentLength(byte index) const;
+
+    // Return the number of segments.
+    byte segments() const;
+
+    // Buffer chains are read-only: this does nothing and returns 0.
+    size_t write(uint8_t datum);
+
+    // Import the rest of the Print::write() overloads.
+    using Print::write;
+
+    // Write the contents of the chain to an output stream with one
+    // bulk write per segment.
+    // Return true on success; otherwise return false.
+    // This leaves the read position untouched.
+    boolean writeTo(Stream& output) const;
+
+#ifdef __linux__
+    // Write the contents of the chain to a file descriptor with a
+    // single writev() system call (plus further calls only after
+    // partial writes).
+    // Return true on success; otherwise return false.
+    // This leaves the read position untouched.
+    boolean writeTo(int fileDescriptor) const;
+#endif
+
+  private:
+    // Segment of the chain.
+    struct Segment
+    {
+      // Start of the segment (nullptr for segments in the inline
+      // storage).
+      const byte* start;
+
+      // Offset of the segment in the inline storage.
+      byte inlineOffset;
+
+      // Number of bytes of the segment.
+      unsigned long length;
+    };
+
+    // Buffers sharing the backend memory of the segments of buffers
+    // and buffer views.
+    ESAT_Buffer buffers[MAXIMUM_BUFFERS];
+
+    // Number of buffers.
+    byte bufferCount;
+
+    // Storage for copied segments.
+    byte inlineStorage[INLINE_CAPACITY];
+
+    // Number of bytes used from the inline storage.
+    byte inlineStorageLength;
+
+    // Position of the next read operation relative to the start of
+    // the current segment.
+    unsigned long positionInSegment;
+
+    // Index of the segment of the next read operation.
+    byte segmentIndex;
+
+    // Segments.
+    Segment segmentList[MAXIMUM_SEGMENTS];
+
+    // Number of segments.
+    byte segmentCount;
+
+    // Append a segment with the contents of a byte array of given
+    // length that lives in the backend memory of the given buffer,
+    // holding a reference to that memory.
+    // Empty segments are ignored.
+    // Return true on success; otherwise (when the chain has no room
+    // for more segments or already holds references to
+    // MAXIMUM_BUFFERS other buffers) return false.
+    boolean append(const ESAT_Buffer& buffer,
+                   const byte array[],
+                   unsigned long arrayLength);
+
+    // Hold a reference to the backend memory of the given buffer
+    // unless the chain already holds one.
+    // Return true on success; otherwise (when the chain already holds
+    // references to MAXIMUM_BUFFERS other buffers) return false.
+    boolean holdReference(const ESAT_Buffer& buffer);
+};
+
+#endif /* ESAT_BufferChain_h */
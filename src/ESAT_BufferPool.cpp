@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_BufferPool.h"
+#include "ESAT_MemoryAccounting.h"
+
+ESAT_BufferPool::ESAT_BufferPool()
+{
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  ownMemory = nullptr;
+  ownMemoryLength = 0;
+  initialize(nullptr, 0, 0);
+}
+
+ESAT_BufferPool::ESAT_BufferPool(const unsigned long blockCapacity,
+                                 const unsigned long numberOfBlocks)
+{
+  const unsigned long length = memoryLength(blockCapacity, numberOfBlocks);
+  ownMemory = new byte[length];
+  if (ownMemory == nullptr)
+  {
+    accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+    ownMemoryLength = 0;
+    initialize(nullptr, 0, blockCapacity);
+  }
+  else
+  {
+    accountedComponent = ESAT_MemoryAccounting.recordAllocation(length);
+    ownMemoryLength = length;
+    initialize(ownMemory, length, blockCapacity);
+  }
+}
+
+ESAT_BufferPool::ESAT_BufferPool(byte array[],
+                                 const unsigned long arrayLength,
+                                 const unsigned long blockCapacity)
+{
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  ownMemory = nullptr;
+  ownMemoryLength = 0;
+  initialize(array, arrayLength, blockCapacity);
+}
+
+ESAT_BufferPool::~ESAT_BufferPool()
+{
+  if (ownMemory != nullptr)
+  {
+    delete[] ownMemory;
+    ESAT_MemoryAccounting.recordDeallocation(accountedComponent,
+                                             ownMemoryLength);
+  }
+}
+
+byte* ESAT_BufferPool::allocate()
+{
+  ESAT_CriticalSection criticalSection;
+  // Just fail if there are no free blocks.
+  if (freeBlocks == nullptr)
+  {
+    failedAllocations = failedAllocations + 1;
+    return nullptr;
+  }
+  // Normal operation: pop the first free block, set its reference
+  // count to 1 and update the statistics.
+  BlockHeader* const block = freeBlocks;
+  freeBlocks = block->nextFreeBlock;
+  block->references.reset(1);
+  block->nextFreeBlock = nullptr;
+  usedBlocks = usedBlocks + 1;
+  if (usedBlocks > maximumBlocksInUse)
+  {
+    maximumBlocksInUse = usedBlocks;
+  }
+  return ((byte*) block) + sizeof(BlockHeader);
+}
+
+unsigned long ESAT_BufferPool::allocationFailures() const
+{
+  ESAT_CriticalSection criticalSection;
+  return failedAllocations;
+}
+
+unsigned long ESAT_BufferPool::availableBlocks() const
+{
+  ESAT_CriticalSection criticalSection;
+  return poolCapacity - usedBlocks;
+}
+
+unsigned long ESAT_BufferPool::blockCapacity() const
+{
+  return poolBlockCapacity;
+}
+
+unsigned long ESAT_BufferPool::blocksInUse() const
+{
+  ESAT_CriticalSection criticalSection;
+  return usedBlocks;
+}
+
+unsigned long ESAT_BufferPool::capacity() const
+{
+  return poolCapacity;
+}
+
+ESAT_BufferPool::BlockHeader* ESAT_BufferPool::header(byte data[])
+{
+  return (BlockHeader*) (data - sizeof(BlockHeader));
+}
+
+unsigned long ESAT_BufferPool::highWaterMark() const
+{
+  ESAT_CriticalSection criticalSection;
+  return maximumBlocksInUse;
+}
+
+void ESAT_BufferPool::initialize(byte memory[],
+                                 const unsigned long memoryLength,
+                                 const unsigned long blockCapacity)
+{
+  failedAllocations = 0;
+  freeBlocks = nullptr;
+  maximumBlocksInUse = 0;
+  poolBlockCapacity = blockCapacity;
+  poolCapacity = 0;
+  usedBlocks = 0;
+  // Fall through when there is no memory.
+  if (memory == nullptr)
+  {
+    return;
+  }
+  // Normal operation: align the start of the memory, construct the
+  // header of each block that fits in it and link the blocks from
+  // last to first, so that the list of free blocks starts at the
+  // lowest address.
+  const unsigned long misalignment = ((uintptr_t) memory) % ALIGNMENT;
+  const unsigned long padding =
+    (misalignment == 0) ? 0 : (ALIGNMENT - misalignment);
+  if (memoryLength < padding)
+  {
+    return;
+  }
+  byte* const start = memory + padding;
+  poolCapacity = (memoryLength - padding) / blockLength(blockCapacity);
+  for (unsigned long index = poolCapacity; index > 0; index = index - 1)
+  {
+    BlockHeader* const block =
+      new (start + (index - 1) * blockLength(blockCapacity)) BlockHeader();
+    block->references.reset(0);
+    block->nextFreeBlock = freeBlocks;
+    freeBlocks = block;
+  }
+}
+
+ESAT_ReferenceCount* ESAT_BufferPool::references(byte data[]) const
+{
+  return &(header(data)->references);
+}
+
+void ESAT_BufferPool::release(byte data[])
+{
+  // Fall through on null blocks.
+  if (data == nullptr)
+  {
+    return;
+  }
+  // Normal operation: push the block to the list of free blocks.
+  ESAT_CriticalSection criticalSection;
+  BlockHeader* const block = header(data);
+  block->references.reset(0);
+  block->nextFreeBlock = freeBlocks;
+  freeBlocks = block;
+  usedBlocks = usedBlocks - 1;
+}
+
+void ESAT_BufferPool::resetStatistics()
+{
+  ESAT_CriticalSection criticalSection;
+  failedAllocations = 0;
+  maximumBlocksInUse = usedBlocks;
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_BufferPool_h
+#define ESAT_BufferPool_h
+
+#include <Arduino.h>
+#include "ESAT_ReferenceCount.h"
+
+// Pool of fixed-capacity memory blocks for ESAT_Buffer and
+// ESAT_CCSDSPacket objects.
+// The pool takes all its memory at once (either from a byte array
+// provided by the caller or with a single allocation when it is
+// created) and then hands out and takes back blocks in constant time
+// from a free list, so buffers drawing from a pool don't fragment the
+// heap and don't suffer from the jitter of the heap allocator.
+// Each block starts with a small header holding the reference count
+// of the block, so buffers drawing from a pool don't need a separate
+// allocation for their reference count.
+// Allocations and releases are atomic, so buffers drawing from a
+// pool can be created and destroyed from interrupt handlers.
+// Pools can't be copied, as buffers keep pointers to them: declare
+// them as global variables or as class members and don't destroy them
+// while there are blocks in use.
+class ESAT_BufferPool
+{
+  public:
+    // Instantiate an empty pool.
+    // An empty pool fails all allocations.
+    ESAT_BufferPool();
+
+    // Instantiate a pool of a number of blocks of given capacity.
+    // The pool will allocate its own memory, all at once.
+    ESAT_BufferPool(unsigned long blockCapacity,
+                    unsigned long numberOfBlocks);
+
+    // Instantiate a pool of blocks of given capacity backed by a byte
+    // array of given length.
+    // The pool will fit as many blocks as possible in the array;
+    // use memoryLength() to compute the length of the array needed
+    // for a given number of blocks.
+    ESAT_BufferPool(byte array[],
+                    unsigned long arrayLength,
+                    unsigned long blockCapacity);
+
+    // Pools can't be copied.
+    ESAT_BufferPool(const ESAT_BufferPool& original) = delete;
+
+    // Destroy a pool.
+    // There must be no blocks in use.
+    ~ESAT_BufferPool();
+
+    // Allocate a block.
+    // Return a pointer to the data of the block, with its reference
+    // count set to 1, on success; otherwise (when there are no
+    // free blocks) return nullptr.
+    byte* allocate();
+
+    // Return the number of failed allocations since the pool was
+    // created or since the last call to resetStatistics().
+    unsigned long allocationFailures() const;
+
+    // Return the number of free blocks.
+    unsigned long availableBlocks() const;
+
+    // Return the capacity in bytes of the blocks.
+    unsigned long blockCapacity() const;
+
+    // Return the number of blocks currently allocated.
+    unsigned long blocksInUse() const;
+
+    // Return the total number of blocks of the pool.
+    unsigned long capacity() const;
+
+    // Return the highest number of blocks that were allocated at
+    // the same time since the pool was created or since the last
+    // call to resetStatistics().
+    unsigned long highWaterMark() const;
+
+    // Return the length of a byte array that can hold a number of
+    // blocks of given capacity (including the block headers and the
+    // worst case alignment of the array).
+    static constexpr unsigned long memoryLength(unsigned long blockCapacity,
+                                                unsigned long numberOfBlocks)
+    {
+      return (ALIGNMENT - 1)
+        + numberOfBlocks * blockLength(blockCapacity);
+    }
+
+    // Return a pointer to the reference count stored in the header of
+    // the block with the given data.
+    ESAT_ReferenceCount* references(byte data[]) const;
+
+    // Give a block back to the pool.
+    // The data must come from a call to allocate() of this pool.
+    void release(byte data[]);
+
+    // Reset the allocation failure count and set the high-water mark
+    // to the current number of blocks in use.
+    void resetStatistics();
+
+    // Pools can't be copied.
+    ESAT_BufferPool& operator=(const ESAT_BufferPool& original) = delete;
+
+  private:
+    // Header at the start of each block.
+    struct BlockHeader
+    {
+      // Reference count of an allocated block (0 for free blocks).
+      ESAT_ReferenceCount references;
+
+      // Next free block when this block is free.
+      BlockHeader* nextFreeBlock;
+
+      // Construct a block header in place at the given address.
+      // Not every Arduino core provides the standard <new> header,
+      // so block headers come with their own placement new.
+      static void* operator new(size_t size, void* address)
+      {
+        (void) size;
+        return address;
+      }
+    };
+
+    // Blocks start at multiples of this number of bytes.
+    static const byte ALIGNMENT = alignof(BlockHeader);
+
+    // Memory accounting component charged for the memory allocated
+    // by the pool itself.
+    byte accountedComponent;
+
+    // Number of failed allocations.
+    unsigned long failedAllocations;
+
+    // Head of the list of free blocks.
+    BlockHeader* freeBlocks;
+
+    // Highest number of blocks in use at the same time.
+    unsigned long maximumBlocksInUse;
+
+    // Backend memory allocated by the pool itself
+    // (nullptr when it is provided by the caller).
+    byte* ownMemory;
+
+    // Length of the memory allocated by the pool itself.
+    unsigned long ownMemoryLength;
+
+    // Capacity in bytes of each block, not counting the header.
+    unsigned long poolBlockCapacity;
+
+    // Total number of blocks.
+    unsigned long poolCapacity;
+
+    // Number of blocks currently allocated.
+    unsigned long usedBlocks;
+
+    // Return the number of bytes each block takes, including the
+    // header and the padding needed to keep the next block aligned.
+    static constexpr unsigned long blockLength(unsigned long blockCapacity)
+    {
+      return ((sizeof(BlockHeader) + blockCapacity + ALIGNMENT - 1)
+              / ALIGNMENT)
+        * ALIGNMENT;
+    }
+
+    // Return the header of the block with the given data.
+    static BlockHeader* header(byte data[]);
+
+    // Split the memory into blocks and link them all in the list of
+    // free blocks.
+    void initialize(byte memory[],
+                    unsigned long memoryLength,
+                    unsigned long blockCapacity);
+};
+
+#endif /* ESAT_BufferPool_h */
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_BufferView.h"
+
+ESAT_BufferView::ESAT_BufferView()
+{
+  backendBuffer = ESAT_Buffer();
+  readPosition = 0;
+  triedToReadBeyondViewLength = false;
+  viewLength = 0;
+  viewOffset = 0;
+  // Set the timeout for waiting for stream data to zero, as it
+  // doesn't make sense to wait when reading from these views.
+  setTimeout(0);
+}
+
+ESAT_BufferView::ESAT_BufferView(const ESAT_Buffer& buffer,
+                                 const unsigned long offset,
+                                 const unsigned long length)
+{
+  backendBuffer = buffer;
+  readPosition = 0;
+  triedToReadBeyondViewLength = false;
+  viewOffset = min(offset, buffer.length());
+  viewLength = min(length, buffer.length() - viewOffset);
+  // Set the timeout for waiting for stream data to zero, as it
+  // doesn't make sense to wait when reading from these views.
+  setTimeout(0);
+}
+
+int ESAT_BufferView::available()
+{
+  // Truncate the result of availableBytes() to fit a 16-bit signed
+  // integer.
+  return min(availableBytes(), (unsigned long) 0x7FFF);
+}
+
+unsigned long ESAT_BufferView::availableBytes() const
+{
+  if (readPosition < viewLength)
+  {
+    return viewLength - readPosition;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void ESAT_BufferView::flush()
+{
+  rewind();
+}
+
+unsigned long ESAT_BufferView::length() const
+{
+  return viewLength;
+}
+
+unsigned long ESAT_BufferView::offset() const
+{
+  return viewOffset;
+}
+
+int ESAT_BufferView::peek()
+{
+  // Peeking past the last available byte returns -1.
+  if (availableBytes() == 0)
+  {
+    triedToReadBeyondViewLength = true;
+    return -1;
+  }
+  triedToReadBeyondViewLength = false;
+  return start()[readPosition];
+}
+
+size_t ESAT_BufferView::peekBytes(byte buffer[], const size_t bufferLength)
+{
+  // Fall through when no bytes are requested.
+  if (bufferLength == 0)
+  {
+    return 0;
+  }
+  // Peeking past the last available byte copies only the
+  // available bytes.
+  const unsigned long bytesToCopy =
+    min((unsigned long) bufferLength, availableBytes());
+  if (bytesToCopy < bufferLength)
+  {
+    triedToReadBeyondViewLength = true;
+  }
+  else
+  {
+    triedToReadBeyondViewLength = false;
+  }
+  if (bytesToCopy > 0)
+  {
+    (void) memcpy(buffer, start() + readPosition, bytesToCopy);
+  }
+  return bytesToCopy;
+}
+
+unsigned long ESAT_BufferView::position() const
+{
+  return readPosition;
+}
+
+size_t ESAT_BufferView::printTo(Print& output) const
+{
+  // Fall through when the view is empty.
+  if (viewLength == 0)
+  {
+    return 0;
+  }
+  // Normal operation: print the window through a buffer over the
+  // same memory, which doesn't copy anything.
+  const ESAT_Buffer window(start(), viewLength, viewLength);
+  return window.printTo(output);
+}
+
+int ESAT_BufferView::read()
+{
+  const int datum = peek();
+  // Advance the read position only when there is a byte
+  // available.
+  if (datum > -1)
+  {
+    readPosition = readPosition + 1;
+  }
+  return datum;
+}
+
+size_t ESAT_BufferView::readBytes(char buffer[], const size_t bufferLength)
+{
+  return readBytes((uint8_t*) buffer, bufferLength);
+}
+
+size_t ESAT_BufferView::readBytes(uint8_t buffer[], const size_t bufferLength)
+{
+  const size_t bytesRead = peekBytes(buffer, bufferLength);
+  readPosition = readPosition + bytesRead;
+  return bytesRead;
+}
+
+void ESAT_BufferView::rewind()
+{
+  readPosition = 0;
+}
+
+boolean ESAT_BufferView::seek(const unsigned long newPosition)
+{
+  if (newPosition <= viewLength)
+  {
+    readPosition = newPosition;
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+byte* ESAT_BufferView::start() const
+{
+  return backendBuffer.buffer + viewOffset;
+}
+
+boolean ESAT_BufferView::triedToReadBeyondLength() const
+{
+  return triedToReadBeyondViewLength;
+}
+
+ESAT_BufferView ESAT_BufferView::view(const unsigned long offset,
+                                      const unsigned long length) const
+{
+  const unsigned long subviewOffset = min(offset, viewLength);
+  const unsigned long subviewLength = min(length, viewLength - subviewOffset);
+  return ESAT_BufferView(backendBuffer,
+                         viewOffset + subviewOffset,
+                         subviewLength);
+}
+
+size_t ESAT_BufferView::write(const uint8_t datum)
+{
+  (void) datum;
+  return 0;
+}
+
+boolean ESAT_BufferView::writeTo(Stream& output) const
+{
+  // Avoid writing if the view is empty.
+  if (viewLength == 0)
+  {
+    return true;
+  }
+  // Normal operation: dump the contents of the window.
+  const size_t bytesWritten = output.write(start(), viewLength);
+  if (bytesWritten < viewLength)
+  {
+    return false;
+  }
+  else
+  {
+    return true;
+  }
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_BufferView_h
+#define ESAT_BufferView_h
+
+#include <Arduino.h>
+#include <Stream.h>
+#include "ESAT_Buffer.h"
+
+// Stream interface to a window (an offset and a length) of the
+// contents of an ESAT_Buffer.
+// A buffer view shares the backend memory of the buffer it was made
+// from, so making a view doesn't copy any data.  When the buffer
+// manages its own memory, the view holds a reference to it, so the
+// backend memory stays alive for as long as the view exists.
+// Buffer views are read-only: writes fail, so a view never modifies
+// memory shared with other buffers, packets or views (or borrowed
+// from constant arrays).  Buffers that manage their own memory get a
+// private copy of it when they write while a view holds a reference
+// to it (copy-on-write), so views keep seeing the contents they were
+// made from.
+class ESAT_BufferView: public Printable, public Stream
+{
+  public:
+    // Instantiate an empty buffer view.
+    // An empty buffer view will fail on reads.
+    ESAT_BufferView();
+
+    // Instantiate a view of a window of the contents of a buffer.
+    // The window starts at the given offset from the start of the
+    // buffer and spans the given length, both truncated to the
+    // length() of the buffer.
+    // The read position starts at 0.
+    ESAT_BufferView(const ESAT_Buffer& buffer,
+                    unsigned long offset,
+                    unsigned long length);
+
+    // Return the number of unread bytes available in the view,
+    // truncated to an int.
+    int available();
+
+    // Return the number of unread bytes available in the view.
+    unsigned long availableBytes() const;
+
+    // Set the read position to the start of the view.
+    // The contents of the view are left untouched.
+    void flush();
+
+    // Return the number of bytes of the window.
+    unsigned long length() const;
+
+    // Return the offset of the window from the start of the
+    // backend buffer.
+    unsigned long offset() const;
+
+    // Return the next byte (or -1 if no byte could be read)
+    // without advancing to the next one.
+    int peek();
+
+    // Copy up to bufferLength bytes (bounded by the number of unread
+    // bytes) to a byte buffer without advancing the read position.
+    // Return the number of bytes copied.
+    size_t peekBytes(byte buffer[], size_t bufferLength);
+
+    // Return the read position relative to the start of the
+    // view.
+    unsigned long position() const;
+
+    // Print the contents of the view in human readable form to an
+    // output stream.
+    size_t printTo(Print& output) const;
+
+    // Return the next byte (or -1 if no byte could be read).
+    // Advance the read position by 1, bounded by the length
+    // of the view.
+    int read();
+
+    // Read up to bufferLength bytes (bounded by the number of unread
+    // bytes) into a byte buffer in one bulk copy.
+    // Advance the read position by the number of bytes read.
+    // Return the number of bytes read.
+    size_t readBytes(char buffer[], size_t bufferLength);
+
+    // Read up to bufferLength bytes (bounded by the number of unread
+    // bytes) into a byte buffer in one bulk copy.
+    // Advance the read position by the number of bytes read.
+    // Return the number of bytes read.
+    size_t readBytes(uint8_t buffer[], size_t bufferLength);
+
+    // Set the read position to the start of the view.
+    void rewind();
+
+    // Set the read position to the desired value.
+    // Return true on success; otherwise (when the new position
+    // is greater than length() and it can't be set) return false.
+    boolean seek(unsigned long newPosition);
+
+    // Return true if the last read() or peek() attempt was beyond
+    // the length() of the view; otherwise return false.
+    boolean triedToReadBeyondLength() const;
+
+    // Return a view of a window of the contents of this view.
+    // The window starts at the given offset from the start of this
+    // view and spans the given length, both truncated to the
+    // length() of this view.
+    ESAT_BufferView view(unsigned long offset,
+                         unsigned long length) const;
+
+    // Buffer views are read-only: this does nothing and returns 0.
+    size_t write(uint8_t datum);
+
+    // Import the rest of the Print::write() overloads.
+    using Print::write;
+
+    // Write the contents of the view to an output stream.
+    // Return true on success; otherwise return false.
+    boolean writeTo(Stream& output) const;
+
+  private:
+    // Buffer chains access the window directly.
+    friend class ESAT_BufferChain;
+
+    // Buffer sharing the backend memory of the viewed buffer.
+    ESAT_Buffer backendBuffer;
+
+    // Position of the next read operation, relative to the start of
+    // the view.
+    unsigned long readPosition;
+
+    // Set to true if the last read() or peek() attempt was beyond
+    // the length() of the view; otherwise set to false.
+    boolean triedToReadBeyondViewLength;
+
+    // Number of bytes of the window.
+    unsigned long viewLength;
+
+    // Offset of the window from the start of the backend buffer.
+    unsigned long viewOffset;
+
+    // Return a pointer to the first byte of the window.
+    byte* start() const;
+};
+
+#endif /* ESAT_BufferView_h */
@@ -24,6 +24,12 @@
 ESAT_CCSDSPacket::ESAT_CCSDSPacket()
 {
   packetData = ESAT_Buffer(nullptr, 0);
+  packetDataIsBorrowed = false;
+  packetDataRemainder = ESAT_CRC16(0);
+  packetDataRemainderLength = 0;
+  packetErrorControl = false;
+  packetErrorControlIsCorrect = false;
+  secondaryHeaderIsCached = false;
   // Set the timeout for waiting for stream data to zero, as it
   // doesn't make sense to wait when reading from these packets.
   setTimeout(0);
@@ -32,6 +38,26 @@ ESAT_CCSDSPacket::ESAT_CCSDSPacket()
 ESAT_CCSDSPacket::ESAT_CCSDSPacket(const unsigned long packetDataCapacity)
 {
   packetData = ESAT_Buffer(packetDataCapacity);
+  packetDataIsBorrowed = false;
+  packetDataRemainder = ESAT_CRC16(0);
+  packetDataRemainderLength = 0;
+  packetErrorControl = false;
+  packetErrorControlIsCorrect = false;
+  secondaryHeaderIsCached = false;
+  // Set the timeout for waiting for stream data to zero, as it
+  // doesn't make sense to wait when reading from these packets.
+  setTimeout(0);
+}
+
+ESAT_CCSDSPacket::ESAT_CCSDSPacket(ESAT_BufferPool& pool)
+{
+  packetData = ESAT_Buffer(pool);
+  packetDataIsBorrowed = false;
+  packetDataRemainder = ESAT_CRC16(0);
+  packetDataRemainderLength = 0;
+  packetErrorControl = false;
+  packetErrorControlIsCorrect = false;
+  secondaryHeaderIsCached = false;
   // Set the timeout for waiting for stream data to zero, as it
   // doesn't make sense to wait when reading from these packets.
   setTimeout(0);
@@ -41,6 +67,12 @@ ESAT_CCSDSPacket::ESAT_CCSDSPacket(byte* const buffer,
                                    const unsigned long bufferLength)
 {
   packetData = ESAT_Buffer(buffer, bufferLength);
+  packetDataIsBorrowed = false;
+  packetDataRemainder = ESAT_CRC16(0);
+  packetDataRemainderLength = 0;
+  packetErrorControl = false;
+  packetErrorControlIsCorrect = false;
+  secondaryHeaderIsCached = false;
   // Set the timeout for waiting for stream data to zero, as it
   // doesn't make sense to wait when reading from these packets.
   setTimeout(0);
@@ -58,22 +90,89 @@ unsigned long ESAT_CCSDSPacket::availableBytesToRead() const
   return packetData.availableBytes();
 }
 
+ESAT_BufferChain ESAT_CCSDSPacket::bufferChain() const
+{
+  byte primaryHeaderBytes[primaryHeader.LENGTH];
+  primaryHeader.writeTo(primaryHeaderBytes);
+  ESAT_BufferChain chain;
+  (void) chain.appendCopy(primaryHeaderBytes, sizeof(primaryHeaderBytes));
+  (void) chain.append(secondaryHeaderView());
+  (void) chain.append(userDataView());
+  return chain;
+}
+
 unsigned long ESAT_CCSDSPacket::capacity() const
 {
   return packetData.capacity();
 }
 
-boolean ESAT_CCSDSPacket::copyTo(ESAT_CCSDSPacket& target)
+void ESAT_CCSDSPacket::checkPacketErrorControl()
+{
+  packetErrorControlIsCorrect = false;
+  // Fall through when packet error control is disabled or there is
+  // no room for the packet error control field.
+  if (!packetErrorControl)
+  {
+    return;
+  }
+  const unsigned long length = packetData.length();
+  if (length < PACKET_ERROR_CONTROL_LENGTH)
+  {
+    return;
+  }
+  // Normal operation: the remainder of the whole packet, packet
+  // error control field included, is zero when the field is correct.
+  // This reuses the remainder of the packet data computed while it
+  // was written, so incrementally parsed packets are checked without
+  // a second pass over their packet data.
+  packetErrorControlIsCorrect =
+    (packetErrorControlField(primaryHeader, length) == 0);
+}
+
+boolean ESAT_CCSDSPacket::copyTo(ESAT_CCSDSPacket& target) const
 {
   // Just fail when our packet data cannot fit into the target.
   if (target.capacity() < packetData.length())
   {
-	return false;
+    return false;
   }
   // Normal operation: copy out packet into the target packet.
+  // Empty the target packet data first: writing our packet data
+  // truncates the target to its length, but an empty packet data
+  // field writes nothing and would leave the old one in place.
   target.writePrimaryHeader(primaryHeader);
-  target.rewind();
-  return packetData.writeTo(target);
+  target.packetData.flush();
+  target.secondaryHeaderIsCached = false;
+  target.makePacketDataPrivate(0);
+  target.packetDataRemainder.flush();
+  target.packetDataRemainderLength = 0;
+  const boolean correctCopy = packetData.writeTo(target);
+  // The copy has a correct packet error control field if we have one.
+  target.packetErrorControlIsCorrect =
+    correctCopy
+    && packetErrorControlIsCorrect
+    && target.packetErrorControl;
+  return correctCopy;
+}
+
+boolean ESAT_CCSDSPacket::correctPacketErrorControl() const
+{
+  return packetErrorControlIsCorrect;
+}
+
+void ESAT_CCSDSPacket::disablePacketErrorControl()
+{
+  packetErrorControl = false;
+  packetErrorControlIsCorrect = false;
+}
+
+void ESAT_CCSDSPacket::enablePacketErrorControl()
+{
+  // The packet data written so far will be processed when needed.
+  packetErrorControl = true;
+  packetErrorControlIsCorrect = false;
+  packetDataRemainder.flush();
+  packetDataRemainderLength = 0;
 }
 
 void ESAT_CCSDSPacket::flush()
@@ -81,6 +180,18 @@ void ESAT_CCSDSPacket::flush()
   // Empty both the primary header and the packet data.
   primaryHeader = ESAT_CCSDSPrimaryHeader();
   packetData.flush();
+  secondaryHeaderIsCached = false;
+  packetDataRemainder.flush();
+  packetDataRemainderLength = 0;
+  packetErrorControlIsCorrect = false;
+}
+
+void ESAT_CCSDSPacket::invalidateCachedSecondaryHeaderBeforeWrite()
+{
+  if (packetData.position() < ESAT_CCSDSSecondaryHeader::LENGTH)
+  {
+    secondaryHeaderIsCached = false;
+  }
 }
 
 boolean ESAT_CCSDSPacket::isTelecommand() const
@@ -114,16 +225,100 @@ unsigned long ESAT_CCSDSPacket::length() const
   return primaryHeader.LENGTH + primaryHeader.packetDataLength;
 }
 
+void ESAT_CCSDSPacket::makePacketDataPrivate(const unsigned long bytesToKeep)
+{
+  // Fall through when the packet data is already private.
+  if (!packetDataIsBorrowed)
+  {
+    return;
+  }
+  // Normal operation: copy the bytes to keep to a new buffer of the
+  // same capacity.  If the allocation fails, the new buffer has no
+  // backend memory and later writes will fail.
+  const unsigned long position = packetData.position();
+  ESAT_Buffer privateCopy(packetData.capacity());
+  (void) packetData.writeTo(privateCopy);
+  (void) privateCopy.setLength(min(bytesToKeep, privateCopy.length()));
+  (void) privateCopy.seek(min(position, privateCopy.length()));
+  packetData = static_cast<ESAT_Buffer&&>(privateCopy);
+  packetDataIsBorrowed = false;
+}
+
 unsigned long ESAT_CCSDSPacket::packetDataLength() const
 {
   return packetData.length();
 }
 
+ESAT_BufferView ESAT_CCSDSPacket::packetDataView() const
+{
+  return ESAT_BufferView(packetData, 0, packetData.length());
+}
+
+boolean ESAT_CCSDSPacket::packetErrorControlEnabled() const
+{
+  return packetErrorControl;
+}
+
+word ESAT_CCSDSPacket::packetErrorControlField(const ESAT_CCSDSPrimaryHeader& header,
+                                               const unsigned long length)
+{
+  // Start over if we processed bytes beyond the requested length.
+  if (packetDataRemainderLength > length)
+  {
+    packetDataRemainder.flush();
+    packetDataRemainderLength = 0;
+  }
+  // Process the bytes of packet data that weren't processed when
+  // they were written.
+  ESAT_BufferView pendingData(packetData,
+                              packetDataRemainderLength,
+                              length - packetDataRemainderLength);
+  byte chunk[PACKET_ERROR_CONTROL_CHUNK_LENGTH];
+  while (pendingData.availableBytes() > 0)
+  {
+    const size_t chunkLength = pendingData.readBytes(chunk, sizeof(chunk));
+    (void) packetDataRemainder.write(chunk, chunkLength);
+    packetDataRemainderLength = packetDataRemainderLength + chunkLength;
+  }
+  // Combine the CRC of the primary header with the CRC of the packet
+  // data.
+  byte headerBytes[header.LENGTH];
+  header.writeTo(headerBytes);
+  ESAT_CRC16 headerRemainder;
+  (void) headerRemainder.write(headerBytes, sizeof(headerBytes));
+  return
+    packetDataRemainder.value()
+    ^ ESAT_CRC16::advance(headerRemainder.value(), length);
+}
+
 int ESAT_CCSDSPacket::peek()
 {
   return packetData.peek();
 }
 
+const ESAT_CCSDSSecondaryHeader& ESAT_CCSDSPacket::peekSecondaryHeader() const
+{
+  // Fall through when the cached secondary header is still valid.
+  if (!secondaryHeaderIsCached)
+  {
+    // Decode the secondary header from a copy of its raw bytes, so
+    // that the read/write pointer stays untouched.
+    byte bytes[ESAT_CCSDSSecondaryHeader::LENGTH];
+    ESAT_BufferView view(packetData, 0, sizeof(bytes));
+    const size_t bytesRead = view.readBytes(bytes, sizeof(bytes));
+    (void) memset(bytes + bytesRead, 0, sizeof(bytes) - bytesRead);
+    cachedSecondaryHeader.preamble =
+      (ESAT_CCSDSSecondaryHeader::Preamble) bytes[0];
+    cachedSecondaryHeader.timestamp.readFrom(&bytes[1]);
+    cachedSecondaryHeader.majorVersionNumber = bytes[8];
+    cachedSecondaryHeader.minorVersionNumber = bytes[9];
+    cachedSecondaryHeader.patchVersionNumber = bytes[10];
+    cachedSecondaryHeader.packetIdentifier = bytes[11];
+    secondaryHeaderIsCached = true;
+  }
+  return cachedSecondaryHeader;
+}
+
 unsigned long ESAT_CCSDSPacket::position() const
 {
   return packetData.position();
@@ -211,6 +406,16 @@ byte ESAT_CCSDSPacket::readByte()
   }
 }
 
+size_t ESAT_CCSDSPacket::readBytes(char buffer[], const size_t bufferLength)
+{
+  return packetData.readBytes(buffer, bufferLength);
+}
+
+size_t ESAT_CCSDSPacket::readBytes(uint8_t buffer[], const size_t bufferLength)
+{
+  return packetData.readBytes(buffer, bufferLength);
+}
+
 signed char ESAT_CCSDSPacket::readChar()
 {
   const byte datum = readByte();
@@ -223,6 +428,41 @@ float ESAT_CCSDSPacket::readFloat()
   return ESAT_Util.unsignedLongToFloat(bits);
 }
 
+void ESAT_CCSDSPacket::readFloats(float data[],
+                                  const unsigned long length)
+{
+  readFourByteFields(length,
+                     [&](const unsigned long index, const unsigned long bits)
+                     {
+                       data[index] = ESAT_Util.unsignedLongToFloat(bits);
+                     });
+}
+
+template <typename Store>
+void ESAT_CCSDSPacket::readFourByteFields(const unsigned long length,
+                                          Store store)
+{
+  byte chunk[ARRAY_CHUNK_LENGTH];
+  const unsigned long fieldsPerChunk = ARRAY_CHUNK_LENGTH / 4;
+  for (unsigned long start = 0; start < length; start = start + fieldsPerChunk)
+  {
+    const unsigned long fields = min(length - start, fieldsPerChunk);
+    const size_t chunkLength = 4 * fields;
+    const size_t bytesRead = readBytes(chunk, chunkLength);
+    if (bytesRead < chunkLength)
+    {
+      (void) memset(chunk + bytesRead, 0, chunkLength - bytesRead);
+    }
+    for (unsigned long index = 0; index < fields; index = index + 1)
+    {
+      const byte* const field = &chunk[4 * index];
+      store(start + index,
+            ESAT_Util.unsignedLong(word(field[0], field[1]),
+                                   word(field[2], field[3])));
+    }
+  }
+}
+
 boolean ESAT_CCSDSPacket::readFrom(Stream& input)
 {
   const boolean correctPrimaryHeader =
@@ -233,7 +473,14 @@ boolean ESAT_CCSDSPacket::readFrom(Stream& input)
     return false;
   }
   // Normal operation: read the packet data from the stream.
-  return packetData.readFrom(input, primaryHeader.packetDataLength);
+  secondaryHeaderIsCached = false;
+  makePacketDataPrivate(0);
+  packetDataRemainder.flush();
+  packetDataRemainderLength = 0;
+  const boolean correctPacketData =
+    packetData.readFrom(input, primaryHeader.packetDataLength);
+  checkPacketErrorControl();
+  return correctPacketData;
 }
 
 int ESAT_CCSDSPacket::readInt()
@@ -242,12 +489,32 @@ int ESAT_CCSDSPacket::readInt()
   return ESAT_Util.wordToInt(datum);
 }
 
+void ESAT_CCSDSPacket::readInts(int data[],
+                                const unsigned long length)
+{
+  readTwoByteFields(length,
+                    [&](const unsigned long index, const word bits)
+                    {
+                      data[index] = ESAT_Util.wordToInt(bits);
+                    });
+}
+
 long ESAT_CCSDSPacket::readLong()
 {
   const unsigned long datum = readUnsignedLong();
   return ESAT_Util.unsignedLongToLong(datum);
 }
 
+void ESAT_CCSDSPacket::readLongs(long data[],
+                                 const unsigned long length)
+{
+  readFourByteFields(length,
+                     [&](const unsigned long index, const unsigned long bits)
+                     {
+                       data[index] = ESAT_Util.unsignedLongToLong(bits);
+                     });
+}
+
 ESAT_CCSDSPrimaryHeader ESAT_CCSDSPacket::readPrimaryHeader() const
 {
   return primaryHeader;
@@ -255,6 +522,19 @@ ESAT_CCSDSPrimaryHeader ESAT_CCSDSPacket::readPrimaryHeader() const
 
 ESAT_CCSDSSecondaryHeader ESAT_CCSDSPacket::readSecondaryHeader()
 {
+  // Use the cached secondary header for complete secondary headers
+  // at the beginning of the packet data.
+  if ((packetData.position() == 0)
+      && (packetData.length() >= ESAT_CCSDSSecondaryHeader::LENGTH))
+  {
+    // Read the last byte of the header instead of seeking past it,
+    // so that triedToReadBeyondLength() reports this read just as it
+    // does after a byte-by-byte read.
+    (void) packetData.seek(ESAT_CCSDSSecondaryHeader::LENGTH - 1);
+    (void) packetData.read();
+    return peekSecondaryHeader();
+  }
+  // Decode any other secondary header byte by byte.
   ESAT_CCSDSSecondaryHeader datum;
   datum.preamble = (ESAT_CCSDSSecondaryHeader::Preamble) readByte();
   datum.timestamp = readTimestamp();
@@ -277,6 +557,28 @@ ESAT_Timestamp ESAT_CCSDSPacket::readTimestamp()
   return datum;
 }
 
+template <typename Store>
+void ESAT_CCSDSPacket::readTwoByteFields(const unsigned long length,
+                                         Store store)
+{
+  byte chunk[ARRAY_CHUNK_LENGTH];
+  const unsigned long fieldsPerChunk = ARRAY_CHUNK_LENGTH / 2;
+  for (unsigned long start = 0; start < length; start = start + fieldsPerChunk)
+  {
+    const unsigned long fields = min(length - start, fieldsPerChunk);
+    const size_t chunkLength = 2 * fields;
+    const size_t bytesRead = readBytes(chunk, chunkLength);
+    if (bytesRead < chunkLength)
+    {
+      (void) memset(chunk + bytesRead, 0, chunkLength - bytesRead);
+    }
+    for (unsigned long index = 0; index < fields; index = index + 1)
+    {
+      store(start + index, word(chunk[2 * index], chunk[2 * index + 1]));
+    }
+  }
+}
+
 unsigned long ESAT_CCSDSPacket::readUnsignedLong()
 {
   const word highWord = readWord();
@@ -284,6 +586,16 @@ unsigned long ESAT_CCSDSPacket::readUnsignedLong()
   return ESAT_Util.unsignedLong(highWord, lowWord);
 }
 
+void ESAT_CCSDSPacket::readUnsignedLongs(unsigned long data[],
+                                         const unsigned long length)
+{
+  readFourByteFields(length,
+                     [&](const unsigned long index, const unsigned long bits)
+                     {
+                       data[index] = bits;
+                     });
+}
+
 word ESAT_CCSDSPacket::readWord()
 {
   const byte highByte = readByte();
@@ -291,6 +603,16 @@ word ESAT_CCSDSPacket::readWord()
   return word(highByte, lowByte);
 }
 
+void ESAT_CCSDSPacket::readWords(word data[],
+                                 const unsigned long length)
+{
+  readTwoByteFields(length,
+                    [&](const unsigned long index, const word bits)
+                    {
+                      data[index] = bits;
+                    });
+}
+
 void ESAT_CCSDSPacket::rewind()
 {
   packetData.rewind();
@@ -301,6 +623,16 @@ boolean ESAT_CCSDSPacket::seek(const unsigned long newPosition)
   return packetData.seek(newPosition);
 }
 
+ESAT_BufferView ESAT_CCSDSPacket::secondaryHeaderView() const
+{
+  if (primaryHeader.secondaryHeaderFlag
+      != primaryHeader.SECONDARY_HEADER_IS_PRESENT)
+  {
+    return ESAT_BufferView(packetData, 0, 0);
+  }
+  return ESAT_BufferView(packetData, 0, ESAT_CCSDSSecondaryHeader::LENGTH);
+}
+
 boolean ESAT_CCSDSPacket::triedToReadBeyondLength() const
 {
   return packetData.triedToReadBeyondLength();
@@ -311,9 +643,94 @@ boolean ESAT_CCSDSPacket::triedToWriteBeyondCapacity() const
   return packetData.triedToWriteBeyondCapacity();
 }
 
+void ESAT_CCSDSPacket::updatePacketErrorControl(const unsigned long writePosition,
+                                                const byte data[],
+                                                const unsigned long length)
+{
+  packetErrorControlIsCorrect = false;
+  // Fall through when packet error control is disabled.
+  if (!packetErrorControl)
+  {
+    return;
+  }
+  // Start over if the write overwrote bytes we already processed.
+  if (writePosition < packetDataRemainderLength)
+  {
+    packetDataRemainder.flush();
+    packetDataRemainderLength = 0;
+  }
+  // Normal operation: process the written bytes if they come right
+  // after the ones processed so far; otherwise leave them for
+  // packetErrorControlField().
+  if (writePosition == packetDataRemainderLength)
+  {
+    (void) packetDataRemainder.write(data, length);
+    packetDataRemainderLength = packetDataRemainderLength + length;
+  }
+}
+
+ESAT_BufferView ESAT_CCSDSPacket::userDataView() const
+{
+  if (primaryHeader.secondaryHeaderFlag
+      != primaryHeader.SECONDARY_HEADER_IS_PRESENT)
+  {
+    return packetDataView();
+  }
+  return ESAT_BufferView(packetData,
+                         ESAT_CCSDSSecondaryHeader::LENGTH,
+                         packetData.length());
+}
+
+boolean ESAT_CCSDSPacket::wrap(const byte buffer[],
+                               const unsigned long bufferLength)
+{
+  // Just fail if there isn't a whole primary header.
+  if (bufferLength < ESAT_CCSDSPrimaryHeader::LENGTH)
+  {
+    return false;
+  }
+  ESAT_CCSDSPrimaryHeader wrappedPrimaryHeader;
+  (void) wrappedPrimaryHeader.readFrom(buffer);
+  // Just fail if the packet data is truncated.
+  if (wrappedPrimaryHeader.packetDataLength
+      > (bufferLength - ESAT_CCSDSPrimaryHeader::LENGTH))
+  {
+    return false;
+  }
+  // Normal operation: point the packet data to the array.
+  primaryHeader = wrappedPrimaryHeader;
+  packetData =
+    ESAT_Buffer((byte*) &buffer[ESAT_CCSDSPrimaryHeader::LENGTH],
+                wrappedPrimaryHeader.packetDataLength,
+                wrappedPrimaryHeader.packetDataLength);
+  packetDataIsBorrowed = true;
+  secondaryHeaderIsCached = false;
+  packetDataRemainder.flush();
+  packetDataRemainderLength = 0;
+  checkPacketErrorControl();
+  return true;
+}
+
 size_t ESAT_CCSDSPacket::write(const uint8_t datum)
 {
+  invalidateCachedSecondaryHeaderBeforeWrite();
+  makePacketDataPrivate(packetData.position());
+  const unsigned long writePosition = packetData.position();
   const size_t bytesWritten = packetData.write(datum);
+  updatePacketErrorControl(writePosition, &datum, bytesWritten);
+  // Keep the packet data length field of the primary header updated.
+  primaryHeader.packetDataLength = packetData.length();
+  return bytesWritten;
+}
+
+size_t ESAT_CCSDSPacket::write(const uint8_t* const buffer,
+                               const size_t bufferLength)
+{
+  invalidateCachedSecondaryHeaderBeforeWrite();
+  makePacketDataPrivate(packetData.position());
+  const unsigned long writePosition = packetData.position();
+  const size_t bytesWritten = packetData.write(buffer, bufferLength);
+  updatePacketErrorControl(writePosition, buffer, bytesWritten);
   // Keep the packet data length field of the primary header updated.
   primaryHeader.packetDataLength = packetData.length();
   return bytesWritten;
@@ -358,19 +775,97 @@ void ESAT_CCSDSPacket::writeFloat(const float datum)
   writeUnsignedLong(bits);
 }
 
+void ESAT_CCSDSPacket::writeFloats(const float data[],
+                                   const unsigned long length)
+{
+  writeFourByteFields(length,
+                      [&](const unsigned long index) -> unsigned long
+                      {
+                        return ESAT_Util.floatToUnsignedLong(data[index]);
+                      });
+}
+
+template <typename Encode>
+void ESAT_CCSDSPacket::writeFourByteFields(const unsigned long length,
+                                           Encode encode)
+{
+  byte chunk[ARRAY_CHUNK_LENGTH];
+  const unsigned long fieldsPerChunk = ARRAY_CHUNK_LENGTH / 4;
+  for (unsigned long start = 0; start < length; start = start + fieldsPerChunk)
+  {
+    const unsigned long fields = min(length - start, fieldsPerChunk);
+    for (unsigned long index = 0; index < fields; index = index + 1)
+    {
+      const unsigned long bits = encode(start + index);
+      chunk[4 * index] = bits >> 24;
+      chunk[4 * index + 1] = bits >> 16;
+      chunk[4 * index + 2] = bits >> 8;
+      chunk[4 * index + 3] = bits;
+    }
+    const size_t chunkLength = 4 * fields;
+    if (write(chunk, chunkLength) < chunkLength)
+    {
+      return;
+    }
+  }
+}
+
 void ESAT_CCSDSPacket::writeInt(const int datum)
 {
   writeWord(ESAT_Util.intToWord(datum));
 }
 
+void ESAT_CCSDSPacket::writeInts(const int data[],
+                                 const unsigned long length)
+{
+  writeTwoByteFields(length,
+                     [&](const unsigned long index) -> word
+                     {
+                       return ESAT_Util.intToWord(data[index]);
+                     });
+}
+
 void ESAT_CCSDSPacket::writeLong(const long datum)
 {
   writeUnsignedLong(ESAT_Util.longToUnsignedLong(datum));
 }
 
+void ESAT_CCSDSPacket::writeLongs(const long data[],
+                                  const unsigned long length)
+{
+  writeFourByteFields(length,
+                      [&](const unsigned long index) -> unsigned long
+                      {
+                        return ESAT_Util.longToUnsignedLong(data[index]);
+                      });
+}
+
+boolean ESAT_CCSDSPacket::writePacketErrorControl()
+{
+  // Just fail if packet error control is disabled or there is no
+  // room for the packet error control field.
+  if (!packetErrorControl)
+  {
+    return false;
+  }
+  if ((capacity() - position()) < PACKET_ERROR_CONTROL_LENGTH)
+  {
+    return false;
+  }
+  // Normal operation: compute the field for the packet as it will be
+  // after appending the field and append it.
+  ESAT_CCSDSPrimaryHeader header = primaryHeader;
+  header.packetDataLength = position() + PACKET_ERROR_CONTROL_LENGTH;
+  const word field = packetErrorControlField(header, position());
+  writeWord(field);
+  packetErrorControlIsCorrect = true;
+  return true;
+}
+
 void ESAT_CCSDSPacket::writePrimaryHeader(const ESAT_CCSDSPrimaryHeader datum)
 {
   primaryHeader = datum;
+  packetErrorControlIsCorrect = false;
 }
 
 void ESAT_CCSDSPacket::writeSecondaryHeader(const ESAT_CCSDSSecondaryHeader datum)
@@ -461,14 +956,58 @@ boolean ESAT_CCSDSPacket::writeTo(Stream& output) const
   return packetData.writeTo(output);
 }
 
+template <typename Encode>
+void ESAT_CCSDSPacket::writeTwoByteFields(const unsigned long length,
+                                          Encode encode)
+{
+  byte chunk[ARRAY_CHUNK_LENGTH];
+  const unsigned long fieldsPerChunk = ARRAY_CHUNK_LENGTH / 2;
+  for (unsigned long start = 0; start < length; start = start + fieldsPerChunk)
+  {
+    const unsigned long fields = min(length - start, fieldsPerChunk);
+    for (unsigned long index = 0; index < fields; index = index + 1)
+    {
+      const word bits = encode(start + index);
+      chunk[2 * index] = highByte(bits);
+      chunk[2 * index + 1] = lowByte(bits);
+    }
+    const size_t chunkLength = 2 * fields;
+    if (write(chunk, chunkLength) < chunkLength)
+    {
+      return;
+    }
+  }
+}
+
 void ESAT_CCSDSPacket::writeUnsignedLong(const unsigned long datum)
 {
   writeWord(ESAT_Util.highWord(datum));
   writeWord(ESAT_Util.lowWord(datum));
 }
 
+void ESAT_CCSDSPacket::writeUnsignedLongs(const unsigned long data[],
+                                          const unsigned long length)
+{
+  writeFourByteFields(length,
+                      [&](const unsigned long index) -> unsigned long
+                      {
+                        return data[index];
+                      });
+}
+
 void ESAT_CCSDSPacket::writeWord(const word datum)
 {
   writeByte(highByte(datum));
   writeByte(lowByte(datum));
 }
+
+void ESAT_CCSDSPacket::writeWords(const word data[],
+                                  const unsigned long length)
+{
+  writeTwoByteFields(length,
+                     [&](const unsigned long index) -> word
+                     {
+                       return data[index];
+                     });
+}
+
@@ -23,8 +23,11 @@
 
 #include <Arduino.h>
 #include "ESAT_Buffer.h"
+#include "ESAT_BufferChain.h"
+#include "ESAT_BufferView.h"
 #include "ESAT_CCSDSPrimaryHeader.h"
 #include "ESAT_CCSDSSecondaryHeader.h"
+#include "ESAT_CRC16.h"
 #include "ESAT_Timestamp.h"
 
 // ESAT's CCSDS space packets.
@@ -50,6 +53,13 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // The read/write pointer starts at 0.
     ESAT_CCSDSPacket(unsigned long packetDataCapacity);
 
+    // Instantiate a new packet with a packet data field drawn from a
+    // pool.  The packet data capacity is the block capacity of the
+    // pool, or 0 when the pool has no free blocks.
+    // The primary header starts with all fields set to 0.
+    // The read/write pointer starts at 0.
+    ESAT_CCSDSPacket(ESAT_BufferPool& pool);
+
     // Instantiate a new packet backed with the packet data field
     // (packet payload) given by the given buffer.
     // The buffer must be at least 1 byte long.
@@ -59,6 +69,18 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // The read/write pointer starts at 0.
     ESAT_CCSDSPacket(byte buffer[], unsigned long bufferLength);
 
+    // Copy constructor.
+    // Instantiate a packet with the same primary header and the same
+    // backend packet data memory as another packet.
+    ESAT_CCSDSPacket(const ESAT_CCSDSPacket& original) = default;
+
+    // Move constructor.
+    // Instantiate a packet that takes over the primary header and the
+    // backend packet data memory of another packet, which is left
+    // without packet data field.
+    // This doesn't touch the reference count of the backend memory.
+    ESAT_CCSDSPacket(ESAT_CCSDSPacket&& original) = default;
+
     // Return the number of unread bytes in the packet data (the
     // packet data length minus the position of the read pointer).
     int available();
@@ -67,13 +89,53 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // packet data length minus the position of the read pointer).
     unsigned long availableBytesToRead() const;
 
+    // Return a buffer chain with the raw contents of the packet:
+    // a copy of the primary header followed by the secondary header
+    // and the user data, which are linked in place without copying.
+    // The chain holds a reference to the packet data, so it keeps the
+    // contents the packet had when the chain was made even if the
+    // packet is modified (copy-on-write) or destroyed afterwards.
+    // Packets wrapped around an array of the caller (see wrap()) and
+    // static packets (see ESAT_StaticCCSDSPacket) keep the packet data
+    // in that array, which must stay alive and unmodified while the
+    // chain is in use.
+    ESAT_BufferChain bufferChain() const;
+
     // Return the capacity in bytes of the packet data buffer.
     unsigned long capacity() const;
 
-    // Copy the whole packet contents to a target packet.
+    // Copy the whole packet contents to a target packet, replacing
+    // its previous contents (even when this packet has an empty packet
+    // data field).
     // The copy will fail if the target packet data buffer is too small.
     // Return true on successful copy; otherwise return false.
-    boolean copyTo(ESAT_CCSDSPacket& target);
+    boolean copyTo(ESAT_CCSDSPacket& target) const;
+
+    // Return true if packet error control is enabled and the last 2
+    // bytes of the packet data are a correct packet error control
+    // field for the packet; otherwise return false.
+    // This is a flag set when the packet error control field is
+    // written with writePacketErrorControl() or checked by readFrom()
+    // or wrap() and cleared by any other change of the packet, so it
+    // costs no computation.
+    boolean correctPacketErrorControl() const;
+
+    // Disable packet error control (see enablePacketErrorControl()).
+    void disablePacketErrorControl();
+
+    // Enable packet error control.
+    // The packet error control field is a CRC-16-CCITT (see
+    // ESAT_CRC16) of the whole packet (primary header included) that
+    // takes the last 2 bytes of the packet data field.
+    // With packet error control enabled:
+    // - the CRC of the packet data is updated as it is written, so
+    //   writePacketErrorControl() doesn't need a second pass over the
+    //   packet data to append the packet error control field;
+    // - readFrom() and wrap() check the packet error control field of
+    //   incoming packets, so correctPacketErrorControl() can tell
+    //   corrupted packets apart.
+    // Packet error control is disabled by default.
+    void enablePacketErrorControl();
 
     // Clear the packet.
     // Set all bytes of the primary header to 0.
@@ -96,11 +158,36 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // Return the packet data length of the packet.
     unsigned long packetDataLength() const;
 
+    // Return a view of the whole packet data field.
+    // The view shares the memory of the packet, so it doesn't copy
+    // any data; it is read-only, so it never modifies the packet or
+    // any copies of it.
+    // This leaves the read/write pointer untouched.
+    ESAT_BufferView packetDataView() const;
+
+    // Return true if packet error control is enabled; otherwise
+    // return false.
+    boolean packetErrorControlEnabled() const;
+
     // Return the next 8-bit unsigned integer from the packet data
     // or, if the read/write pointer is at the end of the packet data,
     // return -1.
     int peek();
 
+    // Return the secondary header at the beginning of the packet data.
+    // The secondary header is decoded the first time it is requested
+    // and cached for later calls until one of the first 12 bytes of
+    // the packet data is written through this packet (with write(),
+    // the writeX() methods, flush(), readFrom() or copyTo()), so
+    // routing and filtering on its fields is cheap.
+    // Writes to the packet data memory by other means (such as
+    // through a buffer view or directly to the backend array) don't
+    // invalidate the cached secondary header.
+    // Missing bytes decode as 0 when the packet data field is shorter
+    // than 12 bytes.
+    // This leaves the read/write pointer untouched.
+    const ESAT_CCSDSSecondaryHeader& peekSecondaryHeader() const;
+
     // Return the read/write position.
     unsigned long position() const;
 
@@ -149,6 +236,20 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // before reaching the end of the packet data buffer.
     byte readByte();
 
+    // Read up to bufferLength bytes from the packet data into a byte
+    // buffer in one bulk copy.
+    // This advances the read/write pointer by the number of bytes
+    // read, but limited to the packet data length.
+    // Return the number of bytes read.
+    size_t readBytes(char buffer[], size_t bufferLength);
+
+    // Read up to bufferLength bytes from the packet data into a byte
+    // buffer in one bulk copy.
+    // This advances the read/write pointer by the number of bytes
+    // read, but limited to the packet data length.
+    // Return the number of bytes read.
+    size_t readBytes(uint8_t buffer[], size_t bufferLength);
+
     // Return the next 8-bit signed integer from the packet data.
     // The raw datum is stored in two's complement format.
     // This advances the read/write pointer by 1, but limited
@@ -168,9 +269,21 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // before reaching the end of the packet data buffer.
     float readFloat();
 
+    // Read a number of single-precision floating-point numbers from
+    // the packet data into an array, decoding them in bulk.
+    // The raw data are in the same format as with readFloat(),
+    // and denormal numbers aren't properly handled either.
+    // This advances the read/write pointer by 4 bytes per number,
+    // but limited to the packet data buffer length.
+    // The values are undefined for the numbers that don't fit in the
+    // bytes before reaching the end of the packet data buffer.
+    void readFloats(float data[], unsigned long length);
+
     // Fill the packet with incoming data from an input stream.
     // Return true on success; false otherwise.
     // The read/write pointer goes to the start of the packet data field.
+    // With packet error control enabled, also check the packet error
+    // control field (see correctPacketErrorControl()).
     boolean readFrom(Stream& input);
 
     // Return the next 16-bit signed integer from the packet data.
@@ -182,6 +295,16 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // before reaching the end of the packet data buffer.
     int readInt();
 
+    // Read a number of 16-bit signed integers from the packet data
+    // into an array, decoding them in bulk.
+    // The raw data are stored in big-endian byte order,
+    // two's complement format.
+    // This advances the read/write pointer by 2 bytes per number,
+    // but limited to the packet data buffer length.
+    // The values are undefined for the numbers that don't fit in the
+    // bytes before reaching the end of the packet data buffer.
+    void readInts(int data[], unsigned long length);
+
     // Return the next 32-bit signed integer from the packet data.
     // The raw datum is stored in bin-endian byte order,
     // two's complement format.
@@ -191,6 +314,16 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // before reaching the end of the packet data buffer.
     long readLong();
 
+    // Read a number of 32-bit signed integers from the packet data
+    // into an array, decoding them in bulk.
+    // The raw data are stored in big-endian byte order,
+    // two's complement format.
+    // This advances the read/write pointer by 4 bytes per number,
+    // but limited to the packet data buffer length.
+    // The values are undefined for the numbers that don't fit in the
+    // bytes before reaching the end of the packet data buffer.
+    void readLongs(long data[], unsigned long length);
+
     // Return the primary header of the packet.
     // The primary header is sent as 3 16-bit words.
     // This leaves the read/write pointer untouched.
@@ -207,6 +340,8 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // packet data buffer length.
     // The return value is undefined if there are fewer than 12 bytes before
     // reaching the end of the packet data buffer.
+    // Reads from the beginning of the packet data use the cached
+    // secondary header of peekSecondaryHeader().
     ESAT_CCSDSSecondaryHeader readSecondaryHeader();
 
     // Return the next timestamp from the packet data.
@@ -227,6 +362,15 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // before reaching the end of the packet data buffer.
     unsigned long readUnsignedLong();
 
+    // Read a number of 32-bit unsigned integers from the packet data
+    // into an array, decoding them in bulk.
+    // The raw data are stored in big-endian byte order.
+    // This advances the read/write pointer by 4 bytes per number,
+    // but limited to the packet data buffer length.
+    // The values are undefined for the numbers that don't fit in the
+    // bytes before reaching the end of the packet data buffer.
+    void readUnsignedLongs(unsigned long data[], unsigned long length);
+
     // Return the next 16-bit unsigned integer from the packet data.
     // The raw datum is stored in big-endian byte order.
     // This advances the read/write pointer by 2, but limited to the
@@ -235,6 +379,15 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // before reaching the end of the packet data buffer.
     word readWord();
 
+    // Read a number of 16-bit unsigned integers from the packet data
+    // into an array, decoding them in bulk.
+    // The raw data are stored in big-endian byte order.
+    // This advances the read/write pointer by 2 bytes per number,
+    // but limited to the packet data buffer length.
+    // The values are undefined for the numbers that don't fit in the
+    // bytes before reaching the end of the packet data buffer.
+    void readWords(word data[], unsigned long length);
+
     // Move the read/write pointer to 0: back to the start of the
     // packet data field (packet payload).
     void rewind();
@@ -244,6 +397,17 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // is greater than length() and it can't be set) return false.
     boolean seek(unsigned long newPosition);
 
+    // Return a view of the secondary header: the first 12 bytes of
+    // the packet data field.
+    // The view is empty when the primary header doesn't flag the
+    // secondary header as present, and it is shorter than 12 bytes
+    // when the packet data field is shorter than 12 bytes.
+    // The view shares the memory of the packet, so it doesn't copy
+    // any data; it is read-only, so it never modifies the packet or
+    // any copies of it.
+    // This leaves the read/write pointer untouched.
+    ESAT_BufferView secondaryHeaderView() const;
+
     // Return true if the last read*() or peek() attempt was beyond
     // the length of the packet data field; otherwise return false.
     boolean triedToReadBeyondLength() const;
@@ -252,6 +416,36 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // of the packet data field; otherwise return false.
     boolean triedToWriteBeyondCapacity() const;
 
+    // Return a view of the user data field: the packet data field
+    // after the secondary header (when the primary header flags it
+    // as present).
+    // The view shares the memory of the packet, so it doesn't copy
+    // any data; it is read-only, so it never modifies the packet or
+    // any copies of it.
+    // This leaves the read/write pointer untouched.
+    ESAT_BufferView userDataView() const;
+
+    // Make the packet read its primary header and its packet data
+    // directly from a byte array holding a whole packet, as found in
+    // receive buffers and captured telemetry files, without copying
+    // them.
+    // Return true on success; otherwise return false.
+    // Fail if the array is shorter than the primary header or than
+    // the packet length declared by the primary header.  Any bytes
+    // after the end of the packet are ignored, so length() tells
+    // where the next packet starts.
+    // The capacity of the packet becomes its packet data length.
+    // The packet (and its copies) reads the packet data from the
+    // array, which must outlive them and stay unchanged in the
+    // meantime.  The array is never written to: the first write to
+    // the packet moves the packet data to private heap memory, and
+    // the views of the packet (like userDataView()) are read-only.
+    // The read/write pointer goes to the start of the packet data
+    // field.
+    // With packet error control enabled, also check the packet error
+    // control field (see correctPacketErrorControl()).
+    boolean wrap(const byte buffer[], unsigned long bufferLength);
+
     // Append an 8-bit unsigned integer to the packet data.
     // This advances the read/write pointer by 1, but limited to the
     // packet data buffer length.
@@ -260,13 +454,15 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // Return the number of bytes written.
     size_t write(uint8_t datum);
 
-    // Import size_t Print::write(const uint8_t* buffer, size_t bufferLength).
     // Append the contents of a byte buffer of given length into the packet
-    // data buffer.
+    // data buffer in one bulk copy.
     // This advances the read/write pointer by bufferLength, but limited
     // to the packet data buffer length.
     // Don't append data beyond the end of the packet data buffer.
     // Return the number of bytes written.
+    size_t write(const uint8_t* buffer, size_t bufferLength);
+
+    // Import the rest of the Print::write() overloads.
     using Print::write;
 
     // Append an 8-bit unsigned integer to the packet data.
@@ -326,6 +522,17 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // the packet data buffer.
     void writeFloat(float datum);
 
+    // Append an array of single-precision floating-point numbers to
+    // the packet data, encoding them in bulk.
+    // The raw data are in the same format as with writeFloat(),
+    // and denormal numbers aren't properly handled either.
+    // This advances the read/write pointer by 4 bytes per number,
+    // but limited to the packet data buffer length.
+    // The written values are undefined for the numbers that don't
+    // fit in the bytes before reaching the end of the packet data,
+    // but no data will be written beyond the packet data buffer.
+    void writeFloats(const float data[], unsigned long length);
+
     // Append a 16-bit signed integer to the packet data.
     // The raw datum is stored in big-endian byte order,
     // two's complement format.
@@ -336,6 +543,17 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // the packet data buffer.
     void writeInt(int datum);
 
+    // Append an array of 16-bit signed integers to the packet data,
+    // encoding them in bulk.
+    // The raw data are stored in big-endian byte order,
+    // two's complement format.
+    // This advances the read/write pointer by 2 bytes per number,
+    // but limited to the packet data buffer length.
+    // The written values are undefined for the numbers that don't
+    // fit in the bytes before reaching the end of the packet data,
+    // but no data will be written beyond the packet data buffer.
+    void writeInts(const int data[], unsigned long length);
+
     // Append a 32-bit signed integer to the packet data.
     // The raw datum is stored in big-endian byte order,
     // two's complement format.
@@ -346,6 +564,17 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // the packet data buffer.
     void writeLong(long datum);
 
+    // Append an array of 32-bit signed integers to the packet data,
+    // encoding them in bulk.
+    // The raw data are stored in big-endian byte order,
+    // two's complement format.
+    // This advances the read/write pointer by 4 bytes per number,
+    // but limited to the packet data buffer length.
+    // The written values are undefined for the numbers that don't
+    // fit in the bytes before reaching the end of the packet data,
+    // but no data will be written beyond the packet data buffer.
+    void writeLongs(const long data[], unsigned long length);
+
     // Append the secondary header to the packet data.
     // The raw datum is stored in big-endian byte order, with the
     // timestamp field encoded as a calendar segmented time code,
@@ -360,6 +589,18 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // the packet data buffer.
     void writeSecondaryHeader(ESAT_CCSDSSecondaryHeader datum);
 
+    // Append the packet error control field: a CRC-16-CCITT of the
+    // whole packet, primary header included (see
+    // enablePacketErrorControl()).
+    // Write the field last, after the rest of the packet data and the
+    // primary header are final.
+    // This advances the read/write pointer by 2, but limited to the
+    // packet data buffer length.
+    // Return true on success; otherwise (when packet error control
+    // is disabled or there are fewer than 2 bytes before reaching
+    // the end of the packet data buffer) return false.
+    boolean writePacketErrorControl();
+
     // Write the primary header of the packet.
     // The primary header is sent as 3 16-bit words.
     // This leaves the read/write pointer untouched.
@@ -433,6 +674,16 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // the packet data buffer.
     void writeUnsignedLong(unsigned long datum);
 
+    // Append an array of 32-bit unsigned integers to the packet data,
+    // encoding them in bulk.
+    // The raw data are stored in big-endian byte order.
+    // This advances the read/write pointer by 4 bytes per number,
+    // but limited to the packet data buffer length.
+    // The written values are undefined for the numbers that don't
+    // fit in the bytes before reaching the end of the packet data,
+    // but no data will be written beyond the packet data buffer.
+    void writeUnsignedLongs(const unsigned long data[], unsigned long length);
+
     // Append a 16-bit unsigned integer to the packet data.
     // The raw datum is stored in big-endian byte order.
     // This advances the read/write pointer by 2, but limited to the
@@ -442,12 +693,132 @@ class ESAT_CCSDSPacket: public Printable, public Stream
     // the packet data buffer.
     void writeWord(word datum);
 
+    // Append an array of 16-bit unsigned integers to the packet data,
+    // encoding them in bulk.
+    // The raw data are stored in big-endian byte order.
+    // This advances the read/write pointer by 2 bytes per number,
+    // but limited to the packet data buffer length.
+    // The written values are undefined for the numbers that don't
+    // fit in the bytes before reaching the end of the packet data,
+    // but no data will be written beyond the packet data buffer.
+    void writeWords(const word data[], unsigned long length);
+
+    // Assignment operator: make this packet have the same primary
+    // header and the same backend packet data memory as another
+    // packet.
+    ESAT_CCSDSPacket& operator=(const ESAT_CCSDSPacket& original) = default;
+
+    // Move assignment operator: make this packet take over the primary
+    // header and the backend packet data memory of another packet,
+    // which is left without packet data field.
+    // This doesn't touch the reference count of the backend memory.
+    ESAT_CCSDSPacket& operator=(ESAT_CCSDSPacket&& original) = default;
+
   private:
+    // Incremental packet parsers fill packets through the write
+    // methods and check the packet error control field at the end.
+    friend class ESAT_CCSDSPacketParser;
+
+    // Number of bytes decoded at once by the array read methods and
+    // encoded at once by the array write methods.
+    static const byte ARRAY_CHUNK_LENGTH = 32;
+
     // Buffer with the raw packet data field.
     ESAT_Buffer packetData;
 
     // Primary header field of the packet.
     ESAT_CCSDSPrimaryHeader primaryHeader;
+
+    // Number of bytes copied at once when computing packet error
+    // control fields.
+    static const byte PACKET_ERROR_CONTROL_CHUNK_LENGTH = 32;
+
+    // Number of bytes of the packet error control field.
+    static const byte PACKET_ERROR_CONTROL_LENGTH = 2;
+
+    // Cached secondary header decoded from the beginning of the
+    // packet data by peekSecondaryHeader().
+    // Only valid when secondaryHeaderIsCached is true.
+    mutable ESAT_CCSDSSecondaryHeader cachedSecondaryHeader;
+
+    // True when the packet data lives in the read-only memory of the
+    // caller of wrap().
+    boolean packetDataIsBorrowed;
+
+    // CRC of the first packetDataRemainderLength bytes of the packet
+    // data, starting with a zero remainder.  The CRC of the primary
+    // header is combined with it at the end (see
+    // ESAT_CRC16::advance()), as the primary header changes while the
+    // packet data is written.
+    ESAT_CRC16 packetDataRemainder;
+
+    // Number of bytes of packet data processed by
+    // packetDataRemainder.
+    unsigned long packetDataRemainderLength;
+
+    // True when packet error control is enabled.
+    boolean packetErrorControl;
+
+    // True when the packet ends with a correct packet error control
+    // field (see correctPacketErrorControl()).
+    boolean packetErrorControlIsCorrect;
+
+    // True when cachedSecondaryHeader matches the beginning of the
+    // packet data.
+    mutable boolean secondaryHeaderIsCached;
+
+    // With packet error control enabled, check the packet error
+    // control field of the packet and set packetErrorControlIsCorrect
+    // accordingly.
+    void checkPacketErrorControl();
+
+    // Invalidate the cached secondary header if writing at the
+    // read/write position would modify the bytes it was decoded from.
+    void invalidateCachedSecondaryHeaderBeforeWrite();
+
+    // If the packet data is borrowed from the caller of wrap(),
+    // replace it with a private heap copy of its first bytesToKeep
+    // bytes, keeping the read/write position.  This is the copy part
+    // of copy-on-write for wrapped packets.
+    void makePacketDataPrivate(unsigned long bytesToKeep);
+
+    // Return the packet error control field for the packet with the
+    // given primary header and the first length bytes of the packet
+    // data.
+    // This only processes the bytes of packet data that weren't
+    // processed when they were written.
+    word packetErrorControlField(const ESAT_CCSDSPrimaryHeader& header,
+                                 unsigned long length);
+
+    // Read a number of 4-byte big-endian fields from the packet data
+    // in chunks, with one bulk read per chunk, and pass each one to
+    // store(index, bits).  Missing bytes read as 0.
+    template <typename Store>
+    void readFourByteFields(unsigned long length, Store store);
+
+    // Read a number of 2-byte big-endian fields from the packet data
+    // in chunks, with one bulk read per chunk, and pass each one to
+    // store(index, bits).  Missing bytes read as 0.
+    template <typename Store>
+    void readTwoByteFields(unsigned long length, Store store);
+
+    // Track a write of the given bytes at the given position of the
+    // packet data for packet error control.
+    void updatePacketErrorControl(unsigned long writePosition,
+                                  const byte data[],
+                                  unsigned long length);
+
+    // Write a number of 4-byte big-endian fields, the bits of each
+    // one given by encode(index), to the packet data in chunks, with
+    // one bulk write per chunk.
+    template <typename Encode>
+    void writeFourByteFields(unsigned long length, Encode encode);
+
+    // Write a number of 2-byte big-endian fields, the bits of each
+    // one given by encode(index), to the packet data in chunks, with
+    // one bulk write per chunk.
+    template <typename Encode>
+    void writeTwoByteFields(unsigned long length, Encode encode);
 };
 
 #endif /* ESAT_CCSDSPacket_h */
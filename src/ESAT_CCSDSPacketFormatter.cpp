@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_CCSDSPacketFormatter.h"
+
+// Hexadecimal digit of each possible nibble.
+static const char ESAT_CCSDSPacketFormatter_DIGITS[16] PROGMEM =
+{
+  '0', '1', '2', '3', '4', '5', '6', '7',
+  '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+};
+
+ESAT_CCSDSPacketFormatter::ESAT_CCSDSPacketFormatter()
+{
+  buffer = nullptr;
+  capacity = 0;
+  position = 0;
+}
+
+ESAT_CCSDSPacketFormatter::ESAT_CCSDSPacketFormatter(char theBuffer[],
+                                                     const unsigned long theCapacity)
+{
+  buffer = theBuffer;
+  capacity = theCapacity;
+  position = 0;
+}
+
+void ESAT_CCSDSPacketFormatter::appendCharacter(const char character)
+{
+  if (position < capacity)
+  {
+    buffer[position] = character;
+  }
+  position = position + 1;
+}
+
+void ESAT_CCSDSPacketFormatter::appendDecimal(unsigned long number)
+{
+  // Render the digits backwards, then copy them in the right order.
+  char digits[10];
+  byte numberOfDigits = 0;
+  do
+  {
+    digits[numberOfDigits] = '0' + (number % 10);
+    numberOfDigits = numberOfDigits + 1;
+    number = number / 10;
+  } while (number > 0);
+  while (numberOfDigits > 0)
+  {
+    numberOfDigits = numberOfDigits - 1;
+    appendCharacter(digits[numberOfDigits]);
+  }
+}
+
+void ESAT_CCSDSPacketFormatter::appendHexadecimal(const byte data[],
+                                                  const unsigned long length)
+{
+  // Just count the characters if they don't fit.
+  if ((position > capacity) || (2 * length > capacity - position))
+  {
+    position = position + 2 * length;
+    return;
+  }
+  // Normal operation: look up the digits of each nibble.
+  for (unsigned long i = 0; i < length; i++)
+  {
+    buffer[position] =
+      pgm_read_byte(&ESAT_CCSDSPacketFormatter_DIGITS[data[i] >> 4]);
+    buffer[position + 1] =
+      pgm_read_byte(&ESAT_CCSDSPacketFormatter_DIGITS[data[i] & 0x0F]);
+    position = position + 2;
+  }
+}
+
+void ESAT_CCSDSPacketFormatter::appendHexadecimalPacketData(const ESAT_CCSDSPacket& packet)
+{
+  ESAT_BufferView packetData = packet.packetDataView();
+  byte chunk[CHUNK_LENGTH];
+  while (packetData.availableBytes() > 0)
+  {
+    const size_t chunkLength = packetData.readBytes(chunk, sizeof(chunk));
+    appendHexadecimal(chunk, chunkLength);
+  }
+}
+
+void ESAT_CCSDSPacketFormatter::appendRaw(const byte data[],
+                                          const unsigned long length)
+{
+  // Just count the bytes if they don't fit.
+  if ((position > capacity) || (length > capacity - position))
+  {
+    position = position + length;
+    return;
+  }
+  // Normal operation: copy the bytes.
+  (void) memcpy(&buffer[position], data, length);
+  position = position + length;
+}
+
+void ESAT_CCSDSPacketFormatter::appendText(const __FlashStringHelper* const text)
+{
+  const char* const characters = reinterpret_cast<const char*>(text);
+  for (unsigned long i = 0; ; i++)
+  {
+    const char character = pgm_read_byte(&characters[i]);
+    if (character == '\0')
+    {
+      return;
+    }
+    appendCharacter(character);
+  }
+}
+
+unsigned long ESAT_CCSDSPacketFormatter::finish(const boolean terminateText)
+{
+  const unsigned long length = position;
+  position = 0;
+  // Just fail if the rendered characters didn't fit.
+  unsigned long requiredCapacity = length;
+  if (terminateText)
+  {
+    requiredCapacity = requiredCapacity + 1;
+  }
+  if (requiredCapacity > capacity)
+  {
+    if (terminateText && (capacity > 0))
+    {
+      buffer[0] = '\0';
+    }
+    return 0;
+  }
+  // Normal operation: terminate text formats.
+  if (terminateText)
+  {
+    buffer[length] = '\0';
+  }
+  return length;
+}
+
+unsigned long ESAT_CCSDSPacketFormatter::formatBinary(const ESAT_CCSDSPacket& packet)
+{
+  const unsigned long packetLength =
+    ESAT_CCSDSPrimaryHeader::LENGTH + packet.packetDataLength();
+  const byte lengthBytes[4] = {
+    byte(packetLength >> 24),
+    byte(packetLength >> 16),
+    byte(packetLength >> 8),
+    byte(packetLength),
+  };
+  appendRaw(lengthBytes, sizeof(lengthBytes));
+  byte headerBytes[ESAT_CCSDSPrimaryHeader::LENGTH];
+  primaryHeaderBytes(packet, headerBytes);
+  appendRaw(headerBytes, sizeof(headerBytes));
+  ESAT_BufferView packetData = packet.packetDataView();
+  if ((position <= capacity)
+      && (packetData.length() <= capacity - position))
+  {
+    const size_t bytesRead =
+      packetData.readBytes((byte*) &buffer[position], packetData.length());
+    position = position + bytesRead;
+  }
+  else
+  {
+    position = position + packetData.length();
+  }
+  return finish(false);
+}
+
+unsigned long ESAT_CCSDSPacketFormatter::formatCSV(const ESAT_CCSDSPacket& packet)
+{
+  const ESAT_CCSDSPrimaryHeader primaryHeader = packet.readPrimaryHeader();
+  appendDecimal(primaryHeader.packetVersionNumber);
+  appendCharacter(',');
+  appendDecimal(primaryHeader.packetType);
+  appendCharacter(',');
+  appendDecimal(primaryHeader.secondaryHeaderFlag);
+  appendCharacter(',');
+  appendDecimal(primaryHeader.applicationProcessIdentifier);
+  appendCharacter(',');
+  appendDecimal(primaryHeader.sequenceFlags);
+  appendCharacter(',');
+  appendDecimal(primaryHeader.packetSequenceCount);
+  appendCharacter(',');
+  appendDecimal(primaryHeader.packetDataLength);
+  appendCharacter(',');
+  appendHexadecimalPacketData(packet);
+  return finish(true);
+}
+
+unsigned long ESAT_CCSDSPacketFormatter::formatCSVHeader()
+{
+  appendText(F("packetVersionNumber,"
+               "packetType,"
+               "secondaryHeaderFlag,"
+               "applicationProcessIdentifier,"
+               "sequenceFlags,"
+               "packetSequenceCount,"
+               "packetDataLength,"
+               "packetData"));
+  return finish(true);
+}
+
+unsigned long ESAT_CCSDSPacketFormatter::formatHexadecimal(const ESAT_CCSDSPacket& packet)
+{
+  byte headerBytes[ESAT_CCSDSPrimaryHeader::LENGTH];
+  primaryHeaderBytes(packet, headerBytes);
+  appendHexadecimal(headerBytes, sizeof(headerBytes));
+  appendHexadecimalPacketData(packet);
+  return finish(true);
+}
+
+unsigned long ESAT_CCSDSPacketFormatter::formatJSON(const ESAT_CCSDSPacket& packet)
+{
+  const ESAT_CCSDSPrimaryHeader primaryHeader = packet.readPrimaryHeader();
+  appendText(F("{\"primaryHeader\":{\"packetVersionNumber\":"));
+  appendDecimal(primaryHeader.packetVersionNumber);
+  appendText(F(",\"packetType\":"));
+  appendDecimal(primaryHeader.packetType);
+  appendText(F(",\"secondaryHeaderFlag\":"));
+  appendDecimal(primaryHeader.secondaryHeaderFlag);
+  appendText(F(",\"applicationProcessIdentifier\":"));
+  appendDecimal(primaryHeader.applicationProcessIdentifier);
+  appendText(F(",\"sequenceFlags\":"));
+  appendDecimal(primaryHeader.sequenceFlags);
+  appendText(F(",\"packetSequenceCount\":"));
+  appendDecimal(primaryHeader.packetSequenceCount);
+  appendText(F(",\"packetDataLength\":"));
+  appendDecimal(primaryHeader.packetDataLength);
+  appendText(F("},\"packetData\":\""));
+  appendHexadecimalPacketData(packet);
+  appendText(F("\"}"));
+  return finish(true);
+}
+
+void ESAT_CCSDSPacketFormatter::primaryHeaderBytes(const ESAT_CCSDSPacket& packet,
+                                                   byte bytes[])
+{
+  packet.readPrimaryHeader().writeTo(bytes);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_CCSDSPacketFormatter_h
+#define ESAT_CCSDSPacketFormatter_h
+
+#include <Arduino.h>
+#include "ESAT_CCSDSPacket.h"
+
+// Compact CCSDS space packet formatter.
+// Render packets into a caller-provided buffer in several compact
+// formats without allocating memory, so that all traffic can be
+// logged at high packet rates.  This is much faster than
+// ESAT_CCSDSPacket::printTo(), which is meant for human beings.
+// Text formats are terminated with a null character so that the
+// buffer can be printed directly.
+class ESAT_CCSDSPacketFormatter
+{
+  public:
+    // Instantiate a packet formatter without a buffer.
+    // Every format will fail.
+    ESAT_CCSDSPacketFormatter();
+
+    // Instantiate a packet formatter that will render packets into
+    // the given buffer of given capacity.
+    ESAT_CCSDSPacketFormatter(char buffer[], unsigned long capacity);
+
+    // Render the packet in binary form: its length (primary header
+    // plus packet data) as a 32-bit unsigned integer, most
+    // significant byte first, followed by the raw packet.
+    // This takes 10 bytes plus the packet data length, and there is
+    // no terminating null character.
+    // Return the number of bytes written, or 0 if the packet doesn't
+    // fit in the buffer.
+    unsigned long formatBinary(const ESAT_CCSDSPacket& packet);
+
+    // Render the packet as a comma-separated values row with these
+    // columns (see formatCSVHeader()):
+    // the fields of the primary header as decimal numbers, in the
+    // order they are sent, followed by the packet data in compact
+    // hexadecimal form.
+    // This takes at most 30 characters plus two characters per byte
+    // of packet data plus the terminating null character.
+    // Return the number of characters written (excluding the null
+    // character), or 0 if the row doesn't fit in the buffer.
+    unsigned long formatCSV(const ESAT_CCSDSPacket& packet);
+
+    // Render the header row of formatCSV().
+    // Return the number of characters written (excluding the null
+    // character), or 0 if the row doesn't fit in the buffer.
+    unsigned long formatCSVHeader();
+
+    // Render the packet (primary header plus packet data) in compact
+    // hexadecimal form: two lowercase hexadecimal digits per byte,
+    // without separators.
+    // This takes 12 characters plus two characters per byte of
+    // packet data plus the terminating null character.
+    // Return the number of characters written (excluding the null
+    // character), or 0 if the packet doesn't fit in the buffer.
+    unsigned long formatHexadecimal(const ESAT_CCSDSPacket& packet);
+
+    // Render the packet in compact, single-line JSON form: an object
+    // with the fields of the primary header as numbers, with the
+    // same names as in ESAT_CCSDSPacket::printTo(), and the packet
+    // data as a compact hexadecimal string.
+    // This takes at most 205 characters plus two characters per byte
+    // of packet data plus the terminating null character.
+    // Return the number of characters written (excluding the null
+    // character), or 0 if the packet doesn't fit in the buffer.
+    unsigned long formatJSON(const ESAT_CCSDSPacket& packet);
+
+  private:
+    // Number of bytes of packet data rendered at once.
+    static const byte CHUNK_LENGTH = 32;
+
+    // Render packets here.
+    char* buffer;
+
+    // Capacity of the buffer.
+    unsigned long capacity;
+
+    // Number of characters rendered so far.
+    // This may go beyond the capacity of the buffer, in which case
+    // nothing is written past the end of the buffer and the format
+    // fails.
+    unsigned long position;
+
+    // Append a character.
+    void appendCharacter(char character);
+
+    // Append a number in decimal form.
+    void appendDecimal(unsigned long number);
+
+    // Append the given bytes in compact hexadecimal form.
+    void appendHexadecimal(const byte data[], unsigned long length);
+
+    // Append the packet data of the packet in compact hexadecimal
+    // form.
+    void appendHexadecimalPacketData(const ESAT_CCSDSPacket& packet);
+
+    // Append the given bytes as they are.
+    void appendRaw(const byte data[], unsigned long length);
+
+    // Append a string stored in program memory.
+    void appendText(const __FlashStringHelper* text);
+
+    // Finish rendering.
+    // Append a terminating null character for text formats.
+    // Return the number of characters rendered (excluding the null
+    // character) or 0 if they didn't fit in the buffer.
+    unsigned long finish(boolean terminateText);
+
+    // Store the raw primary header of the packet in the given array.
+    void primaryHeaderBytes(const ESAT_CCSDSPacket& packet,
+                            byte bytes[]);
+};
+
+#endif /* ESAT_CCSDSPacketFormatter_h */
@@ -22,6 +22,7 @@
 
 ESAT_CCSDSPacketFromKISSFrameReader::ESAT_CCSDSPacketFromKISSFrameReader()
 {
+  frameQueue = nullptr;
   reader = ESAT_KISSStream();
 }
 
@@ -30,6 +31,17 @@ ESAT_CCSDSPacketFromKISSFrameReader::ESAT_CCSDSPacketFromKISSFrameReader(Stream&
 {
   const unsigned long maximumPacketLength =
     maximumPacketDataLength + ESAT_CCSDSPrimaryHeader::LENGTH;
+  frameQueue = nullptr;
+  reader = ESAT_KISSStream(backend, maximumPacketLength);
+}
+
+ESAT_CCSDSPacketFromKISSFrameReader::ESAT_CCSDSPacketFromKISSFrameReader(Stream& backend,
+                                                                         const unsigned long maximumPacketDataLength,
+                                                                         ESAT_KISSFrameQueue& queue)
+{
+  const unsigned long maximumPacketLength =
+    maximumPacketDataLength + ESAT_CCSDSPrimaryHeader::LENGTH;
+  frameQueue = &queue;
   reader = ESAT_KISSStream(backend, maximumPacketLength);
 }
 
@@ -37,11 +49,16 @@ ESAT_CCSDSPacketFromKISSFrameReader::ESAT_CCSDSPacketFromKISSFrameReader(Stream&
                                                                          byte buffer[],
                                                                          const unsigned long capacity)
 {
+  frameQueue = nullptr;
   reader = ESAT_KISSStream(backend, buffer, capacity);
 }
 
 boolean ESAT_CCSDSPacketFromKISSFrameReader::read(ESAT_CCSDSPacket& packet)
 {
+  if (frameQueue)
+  {
+    return readFromQueue(packet);
+  }
   const boolean gotFrame = reader.receiveFrame();
   if (gotFrame)
   {
@@ -52,3 +69,19 @@ boolean ESAT_CCSDSPacketFromKISSFrameReader::read(ESAT_CCSDSPacket& packet)
     return false;
   }
 }
+
+boolean ESAT_CCSDSPacketFromKISSFrameReader::readFromQueue(ESAT_CCSDSPacket& packet)
+{
+  (void) reader.receiveFrames(*frameQueue);
+  // Just fail if there are no frames.
+  if (frameQueue->availableForRead() == 0)
+  {
+    return false;
+  }
+  // Normal operation: fill the packet with the oldest frame and drop
+  // it from the queue.
+  ESAT_BufferView frame = frameQueue->frame();
+  const boolean correctPacket = packet.readFrom(frame);
+  frameQueue->drop();
+  return correctPacket;
+}
@@ -42,6 +42,17 @@ class ESAT_CCSDSPacketFromKISSFrameReader
     ESAT_CCSDSPacketFromKISSFrameReader(Stream& backend,
                                         unsigned long maximumPacketDataLength);
 
+    // Instantiate a CCSDS-from-KISS reader that will read data from
+    // this backend stream.
+    // Buffer packets with the given maximum packet data length.
+    // Receive every complete frame available from the backend stream
+    // at once into the given frame queue, so that bursts of frames
+    // don't overflow the backend stream while they are read one by
+    // one.  The queue must outlive the reader.
+    ESAT_CCSDSPacketFromKISSFrameReader(Stream& backend,
+                                        unsigned long maximumPacketDataLength,
+                                        ESAT_KISSFrameQueue& queue);
+
     // Instantiate a CCSDS-from-KISS reader that will read data from
     // this backend stream.
     // Use the buffer of given capacity to store frame contents.
@@ -51,12 +62,25 @@ class ESAT_CCSDSPacketFromKISSFrameReader
 
     // Read and fill the contents of CCSDS packet from a KISS frame
     // coming from the backend stream.
+    // Readers with a frame queue first move the frames available
+    // from the backend stream to the queue and then read the oldest
+    // queued frame.
     // Return true on success; otherwise return false.
     boolean read(ESAT_CCSDSPacket& packet);
 
   private:
+    // Queue of received frames (nullptr when frames are read one at
+    // a time).
+    ESAT_KISSFrameQueue* frameQueue;
+
     // Read frames from KISS stream.
     ESAT_KISSStream reader;
+
+    // Move the frames available from the backend stream to the frame
+    // queue and fill the contents of a CCSDS packet from the oldest
+    // queued frame.
+    // Return true on success; otherwise return false.
+    boolean readFromQueue(ESAT_CCSDSPacket& packet);
 };
 
 #endif /* ESAT_CCSDSPacketFromKISSFrameReader_h */
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_CCSDSPacketParser.h"
+
+ESAT_CCSDSPacketParser::ESAT_CCSDSPacketParser()
+{
+  packet = nullptr;
+  reset();
+}
+
+ESAT_CCSDSPacketParser::ESAT_CCSDSPacketParser(ESAT_CCSDSPacket& thePacket)
+{
+  packet = &thePacket;
+  reset();
+}
+
+void ESAT_CCSDSPacketParser::finishPacket()
+{
+  // Just fail if we discarded the packet data.
+  if (skippingPacketData)
+  {
+    currentState = INVALID_PACKET;
+    return;
+  }
+  // Just fail if the packet error control field is wrong.
+  packet->rewind();
+  packet->checkPacketErrorControl();
+  if (packet->packetErrorControlEnabled()
+      && !packet->correctPacketErrorControl())
+  {
+    currentState = INVALID_PACKET;
+    return;
+  }
+  // Normal operation: the packet is ready.
+  currentState = PACKET_COMPLETE;
+}
+
+ESAT_CCSDSPacketParser::State ESAT_CCSDSPacketParser::readFrom(Stream& input)
+{
+  // Parse chunks no longer than the number of available bytes so
+  // that reads never wait, and no longer than the rest of the packet
+  // so that no byte of the next packet is consumed.
+  byte chunk[STREAM_CHUNK_LENGTH];
+  do
+  {
+    const int availableBytes = input.available();
+    if (availableBytes <= 0)
+    {
+      break;
+    }
+    unsigned long chunkLength = availableBytes;
+    if (chunkLength > sizeof(chunk))
+    {
+      chunkLength = sizeof(chunk);
+    }
+    if (currentState != NEED_MORE_DATA)
+    {
+      reset();
+    }
+    unsigned long bytesLeft;
+    if (primaryHeaderLength < ESAT_CCSDSPrimaryHeader::LENGTH)
+    {
+      bytesLeft = ESAT_CCSDSPrimaryHeader::LENGTH - primaryHeaderLength;
+    }
+    else
+    {
+      bytesLeft = packetDataBytesLeft;
+    }
+    if (chunkLength > bytesLeft)
+    {
+      chunkLength = bytesLeft;
+    }
+    const size_t bytesRead = input.readBytes((char*) chunk, chunkLength);
+    (void) write(chunk, bytesRead);
+    if (bytesRead < chunkLength)
+    {
+      break;
+    }
+  } while (currentState == NEED_MORE_DATA);
+  return currentState;
+}
+
+void ESAT_CCSDSPacketParser::reset()
+{
+  primaryHeaderLength = 0;
+  packetDataBytesLeft = 0;
+  skippingPacketData = false;
+  currentState = NEED_MORE_DATA;
+}
+
+void ESAT_CCSDSPacketParser::startPacketData()
+{
+  ESAT_CCSDSPrimaryHeader primaryHeader;
+  primaryHeader.readFrom(primaryHeaderBytes);
+  packetDataBytesLeft = primaryHeader.packetDataLength;
+  // Discard the packet data if it doesn't fit in the target packet.
+  if ((packet == nullptr)
+      || (primaryHeader.packetDataLength > packet->capacity()))
+  {
+    skippingPacketData = true;
+    return;
+  }
+  // The packet data length of the target packet grows as its packet
+  // data is written.
+  packet->flush();
+  packet->writePrimaryHeader(primaryHeader);
+}
+
+ESAT_CCSDSPacketParser::State ESAT_CCSDSPacketParser::state() const
+{
+  return currentState;
+}
+
+size_t ESAT_CCSDSPacketParser::write(const uint8_t datum)
+{
+  return write(&datum, 1);
+}
+
+size_t ESAT_CCSDSPacketParser::write(const uint8_t buffer[],
+                                     const size_t bufferLength)
+{
+  if (bufferLength == 0)
+  {
+    return 0;
+  }
+  if (currentState != NEED_MORE_DATA)
+  {
+    reset();
+  }
+  size_t bytesConsumed = 0;
+  // Accumulate the primary header.
+  while ((primaryHeaderLength < ESAT_CCSDSPrimaryHeader::LENGTH)
+         && (bytesConsumed < bufferLength))
+  {
+    primaryHeaderBytes[primaryHeaderLength] = buffer[bytesConsumed];
+    primaryHeaderLength = primaryHeaderLength + 1;
+    bytesConsumed = bytesConsumed + 1;
+    if (primaryHeaderLength == ESAT_CCSDSPrimaryHeader::LENGTH)
+    {
+      startPacketData();
+    }
+  }
+  if (primaryHeaderLength < ESAT_CCSDSPrimaryHeader::LENGTH)
+  {
+    return bytesConsumed;
+  }
+  // Copy the packet data in bulk.
+  unsigned long chunkLength = bufferLength - bytesConsumed;
+  if (chunkLength > packetDataBytesLeft)
+  {
+    chunkLength = packetDataBytesLeft;
+  }
+  if (!skippingPacketData)
+  {
+    (void) packet->write(&buffer[bytesConsumed], chunkLength);
+  }
+  bytesConsumed = bytesConsumed + chunkLength;
+  packetDataBytesLeft = packetDataBytesLeft - chunkLength;
+  if (packetDataBytesLeft == 0)
+  {
+    finishPacket();
+  }
+  return bytesConsumed;
+}
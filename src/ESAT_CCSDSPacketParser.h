@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_CCSDSPacketParser_h
+#define ESAT_CCSDSPacketParser_h
+
+#include <Arduino.h>
+#include "ESAT_CCSDSPacket.h"
+
+// Incremental CCSDS space packet parser.
+// Fill a packet with bytes as they arrive, one at a time or in
+// chunks of any size, without blocking and without losing the
+// progress made on partially received packets.
+// Each write stops at the end of a packet, so the caller can check
+// the parsing state and handle the packet before writing the bytes
+// of the next one.
+// The packet error control field of packets with packet error
+// control enabled is checked as the packet data arrives.
+class ESAT_CCSDSPacketParser: public Print
+{
+  public:
+    // State of the parser after the last write.
+    enum State
+    {
+      NEED_MORE_DATA,
+      PACKET_COMPLETE,
+      INVALID_PACKET,
+    };
+
+    // Instantiate an incremental packet parser without a target
+    // packet.
+    // Every parsed packet will be invalid.
+    ESAT_CCSDSPacketParser();
+
+    // Instantiate an incremental packet parser that will fill this
+    // packet.
+    // The packet must stay alive while the parser is in use.
+    ESAT_CCSDSPacketParser(ESAT_CCSDSPacket& packet);
+
+    // Parse the bytes available from the input stream, up to the end
+    // of the current packet.
+    // This never waits for bytes that aren't available yet.
+    // Return the state of the parser.
+    State readFrom(Stream& input);
+
+    // Discard the bytes of the partially parsed packet and start
+    // parsing a new packet.
+    void reset();
+
+    // Return the state of the parser:
+    // NEED_MORE_DATA while the current packet is incomplete;
+    // PACKET_COMPLETE once the last byte of a valid packet was
+    // written, with the packet rewound and ready to be read;
+    // INVALID_PACKET once the last byte of a packet that didn't fit
+    // in the target packet or had a wrong packet error control field
+    // was written.
+    // The next write after PACKET_COMPLETE or INVALID_PACKET starts a
+    // new packet.
+    State state() const;
+
+    // Parse a byte.
+    // Return the number of bytes consumed (1).
+    size_t write(uint8_t datum);
+
+    // Parse bytes from a buffer, up to the end of the current packet.
+    // Return the number of bytes consumed, which is less than the
+    // buffer length when a packet ends before the end of the buffer.
+    size_t write(const uint8_t buffer[], size_t bufferLength);
+
+  private:
+    // Number of bytes read at once from input streams.
+    static const byte STREAM_CHUNK_LENGTH = 32;
+
+    // Parsed packets go here.
+    ESAT_CCSDSPacket* packet;
+
+    // Raw bytes of the primary header of the current packet.
+    byte primaryHeaderBytes[ESAT_CCSDSPrimaryHeader::LENGTH];
+
+    // Number of bytes of the primary header parsed so far.
+    byte primaryHeaderLength;
+
+    // Number of bytes of packet data of the current packet still to
+    // be parsed.
+    unsigned long packetDataBytesLeft;
+
+    // True when the packet data of the current packet is being
+    // discarded because it doesn't fit in the target packet.
+    boolean skippingPacketData;
+
+    // State of the parser after the last write.
+    State currentState;
+
+    // Finish the current packet and update the state of the parser.
+    void finishPacket();
+
+    // Prepare the target packet for the packet data of the current
+    // packet once its primary header is complete.
+    void startPacketData();
+};
+
+#endif /* ESAT_CCSDSPacketParser_h */
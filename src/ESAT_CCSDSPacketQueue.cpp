@@ -19,9 +19,11 @@
  */
 
 #include "ESAT_CCSDSPacketQueue.h"
+#include "ESAT_MemoryAccounting.h"
 
 ESAT_CCSDSPacketQueue::ESAT_CCSDSPacketQueue()
 {
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
   queueCapacity = 0;
   packets = nullptr;
   unread = nullptr;
@@ -32,13 +34,22 @@ ESAT_CCSDSPacketQueue::ESAT_CCSDSPacketQueue()
 ESAT_CCSDSPacketQueue::ESAT_CCSDSPacketQueue(const unsigned long numberOfPackets,
                                              const unsigned long packetDataCapacity)
 {
+  // The packet data buffers are charged to the queue too.
+  ESAT_MemoryAccountingScope accountingScope(ESAT_MemoryAccounting.PACKET_QUEUE);
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
   queueCapacity = numberOfPackets;
+  packets = nullptr;
+  unread = nullptr;
   if (queueCapacity != 0)
   {
     packets = ::new ESAT_CCSDSPacket[queueCapacity];
     unread = new boolean[queueCapacity];
+    accountedComponent =
+      ESAT_MemoryAccounting.recordAllocation(allocationLength());
     for (unsigned long index = 0; index < queueCapacity; index = index + 1)
     {
+      // The temporary packet is moved into place, so its packet
+      // data buffer is allocated just once.
       packets[index] = ESAT_CCSDSPacket(packetDataCapacity);
       unread[index] = false;
     }
@@ -47,48 +58,57 @@ ESAT_CCSDSPacketQueue::ESAT_CCSDSPacketQueue(const unsigned long numberOfPackets
   writePosition = 0;
 }
 
-ESAT_CCSDSPacketQueue::ESAT_CCSDSPacketQueue(const ESAT_CCSDSPacketQueue& original)
+ESAT_CCSDSPacketQueue::ESAT_CCSDSPacketQueue(const unsigned long numberOfPackets,
+                                             ESAT_BufferPool& pool)
 {
-  if (packets != nullptr)
-  {
-    ::delete[] packets;
-  }
-  if (unread != nullptr)
-  {
-    delete[] unread;
-  }
-  queueCapacity = original.queueCapacity;
-  readPosition = original.readPosition;
-  writePosition = original.writePosition;
-  if ((queueCapacity != 0) && (original.packets != nullptr))
+  // The packet data buffers are charged to the queue too.
+  ESAT_MemoryAccountingScope accountingScope(ESAT_MemoryAccounting.PACKET_QUEUE);
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  queueCapacity = numberOfPackets;
+  packets = nullptr;
+  unread = nullptr;
+  if (queueCapacity != 0)
   {
     packets = ::new ESAT_CCSDSPacket[queueCapacity];
-    for (unsigned long index = 0; index < queueCapacity; index = index + 1)
-    {
-      packets[index] = ESAT_CCSDSPacket(original.packets[index].capacity());
-      (void) original.packets[index].copyTo(packets[index]);
-    }
-  }
-  if ((queueCapacity != 0) && (original.unread != nullptr))
-  {
     unread = new boolean[queueCapacity];
+    accountedComponent =
+      ESAT_MemoryAccounting.recordAllocation(allocationLength());
     for (unsigned long index = 0; index < queueCapacity; index = index + 1)
     {
-      unread[index] = original.unread[index];
+      packets[index] = ESAT_CCSDSPacket(pool);
+      unread[index] = false;
     }
   }
+  readPosition = 0;
+  writePosition = 0;
+}
+
+ESAT_CCSDSPacketQueue::ESAT_CCSDSPacketQueue(const ESAT_CCSDSPacketQueue& original)
+{
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  queueCapacity = 0;
+  packets = nullptr;
+  unread = nullptr;
+  copyFrom(original);
+}
+
+ESAT_CCSDSPacketQueue::ESAT_CCSDSPacketQueue(ESAT_CCSDSPacketQueue&& original)
+{
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  queueCapacity = 0;
+  packets = nullptr;
+  unread = nullptr;
+  moveFrom(original);
 }
 
 ESAT_CCSDSPacketQueue::~ESAT_CCSDSPacketQueue()
 {
-  if (packets != nullptr)
-  {
-    ::delete[] packets;
-  }
-  if (unread != nullptr)
-  {
-    delete[] unread;
-  }
+  clear();
+}
+
+unsigned long ESAT_CCSDSPacketQueue::allocationLength() const
+{
+  return queueCapacity * (sizeof(ESAT_CCSDSPacket) + sizeof(boolean));
 }
 
 unsigned long ESAT_CCSDSPacketQueue::availableForRead() const
@@ -114,6 +134,61 @@ unsigned long ESAT_CCSDSPacketQueue::capacity() const
   return queueCapacity;
 }
 
+void ESAT_CCSDSPacketQueue::clear()
+{
+  if (queueCapacity != 0)
+  {
+    ESAT_MemoryAccounting.recordDeallocation(accountedComponent,
+                                             allocationLength());
+  }
+  if (packets != nullptr)
+  {
+    ::delete[] packets;
+  }
+  if (unread != nullptr)
+  {
+    delete[] unread;
+  }
+  queueCapacity = 0;
+  packets = nullptr;
+  unread = nullptr;
+  readPosition = 0;
+  writePosition = 0;
+}
+
+void ESAT_CCSDSPacketQueue::copyFrom(const ESAT_CCSDSPacketQueue& original)
+{
+  ESAT_MemoryAccountingScope accountingScope(ESAT_MemoryAccounting.PACKET_QUEUE);
+  queueCapacity = original.queueCapacity;
+  readPosition = original.readPosition;
+  writePosition = original.writePosition;
+  if (queueCapacity != 0)
+  {
+    accountedComponent =
+      ESAT_MemoryAccounting.recordAllocation(allocationLength());
+  }
+  if ((queueCapacity != 0) && (original.packets != nullptr))
+  {
+    packets = ::new ESAT_CCSDSPacket[queueCapacity];
+    for (unsigned long index = 0; index < queueCapacity; index = index + 1)
+    {
+      // Give each slot its own packet data buffer, so that later
+      // writes to the queue don't need to allocate memory for
+      // copy-on-write.
+      packets[index] = ESAT_CCSDSPacket(original.packets[index].capacity());
+      (void) original.packets[index].copyTo(packets[index]);
+    }
+  }
+  if ((queueCapacity != 0) && (original.unread != nullptr))
+  {
+    unread = new boolean[queueCapacity];
+    for (unsigned long index = 0; index < queueCapacity; index = index + 1)
+    {
+      unread[index] = original.unread[index];
+    }
+  }
+}
+
 void ESAT_CCSDSPacketQueue::flush()
 {
   if (packets == nullptr)
@@ -128,6 +203,22 @@ void ESAT_CCSDSPacketQueue::flush()
   writePosition = 0;
 }
 
+void ESAT_CCSDSPacketQueue::moveFrom(ESAT_CCSDSPacketQueue& original)
+{
+  accountedComponent = original.accountedComponent;
+  queueCapacity = original.queueCapacity;
+  packets = original.packets;
+  readPosition = original.readPosition;
+  unread = original.unread;
+  writePosition = original.writePosition;
+  original.accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  original.queueCapacity = 0;
+  original.packets = nullptr;
+  original.readPosition = 0;
+  original.unread = nullptr;
+  original.writePosition = 0;
+}
+
 boolean ESAT_CCSDSPacketQueue::read(ESAT_CCSDSPacket& packet)
 {
   if (packets == nullptr)
@@ -156,7 +247,7 @@ boolean ESAT_CCSDSPacketQueue::read(ESAT_CCSDSPacket& packet)
   return false;
 }
 
-boolean ESAT_CCSDSPacketQueue::write(ESAT_CCSDSPacket packet)
+boolean ESAT_CCSDSPacketQueue::write(const ESAT_CCSDSPacket& packet)
 {
   if (packets == nullptr)
   {
@@ -188,34 +279,18 @@ ESAT_CCSDSPacketQueue& ESAT_CCSDSPacketQueue::operator=(const ESAT_CCSDSPacketQu
 {
   if (this != &original)
   {
-    if (packets != nullptr)
-    {
-      ::delete[] packets;
-    }
-    if (unread != nullptr)
-    {
-      delete[] unread;
-    }
-    queueCapacity = original.queueCapacity;
-    readPosition = original.readPosition;
-    writePosition = original.writePosition;
-    if ((queueCapacity != 0) && (original.packets != nullptr))
-    {
-      packets = ::new ESAT_CCSDSPacket[queueCapacity];
-      for (unsigned long index = 0; index < queueCapacity; index = index + 1)
-      {
-        packets[index] = ESAT_CCSDSPacket(original.packets[index].capacity());
-        (void) original.packets[index].copyTo(packets[index]);
-      }
-    }
-    if ((queueCapacity != 0) && (original.unread != nullptr))
-    {
-      unread = new boolean[queueCapacity];
-      for (unsigned long index = 0; index < queueCapacity; index = index + 1)
-      {
-        unread[index] = original.unread[index];
-      }
-    }
+    clear();
+    copyFrom(original);
+  }
+  return *this;
+}
+
+ESAT_CCSDSPacketQueue& ESAT_CCSDSPacketQueue::operator=(ESAT_CCSDSPacketQueue&& original)
+{
+  if (this != &original)
+  {
+    clear();
+    moveFrom(original);
   }
   return *this;
 }
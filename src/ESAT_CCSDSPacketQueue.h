@@ -36,10 +36,26 @@ class ESAT_CCSDSPacketQueue
     ESAT_CCSDSPacketQueue(unsigned long numberOfPackets,
                           unsigned long packetDataCapacity);
 
+    // Instantiate a packet queue that can hold a number of packets,
+    // each one of them with a packet data field drawn from a pool.
+    // The packet data capacity is the block capacity of the pool;
+    // packets that don't get a block from the pool have zero
+    // capacity.
+    ESAT_CCSDSPacketQueue(unsigned long numberOfPackets,
+                          ESAT_BufferPool& pool);
+
     // Copy constructor.
     // Instantiate a packet queue as a copy of another packet queue.
+    // Each packet of the copy gets its own packet data buffer, so
+    // writes to either queue don't allocate memory.
     ESAT_CCSDSPacketQueue(const ESAT_CCSDSPacketQueue& original);
 
+    // Move constructor.
+    // Instantiate a packet queue that takes over the packets of
+    // another packet queue, which is left with zero capacity.
+    // This doesn't allocate or copy any packet.
+    ESAT_CCSDSPacketQueue(ESAT_CCSDSPacketQueue&& original);
+
     // Destroy a packet queue.
     ~ESAT_CCSDSPacketQueue();
 
@@ -75,13 +91,25 @@ class ESAT_CCSDSPacketQueue
     boolean read(ESAT_CCSDSPacket& packet);
 
     // Push a new packet to the queue.
+    // The contents of the packet are copied into the queue.
     // Return true on success; otherwise return false.
-    boolean write(ESAT_CCSDSPacket packet);
+    boolean write(const ESAT_CCSDSPacket& packet);
 
     // Assignment operator: make this queue a copy of another packet queue.
+    // Each packet of the copy gets its own packet data buffer, so
+    // writes to either queue don't allocate memory.
     ESAT_CCSDSPacketQueue& operator=(const ESAT_CCSDSPacketQueue& original);
 
+    // Move assignment operator: make this queue take over the packets
+    // of another packet queue, which is left with zero capacity.
+    // This doesn't allocate or copy any packet.
+    ESAT_CCSDSPacketQueue& operator=(ESAT_CCSDSPacketQueue&& original);
+
   private:
+    // Memory accounting component charged for the packet buffer and
+    // the unread flags.
+    byte accountedComponent;
+
     // Capacity of the packet queue.
     unsigned long queueCapacity;
 
@@ -96,6 +124,23 @@ class ESAT_CCSDSPacketQueue
 
     // Index of the next packet to be written.
     unsigned long writePosition;
+
+    // Return the number of bytes of heap memory taken by the packet
+    // buffer and the unread flags.
+    unsigned long allocationLength() const;
+
+    // Free the packet buffer and the unread flags and leave the
+    // queue with zero capacity.
+    void clear();
+
+    // Make this queue a copy of another packet queue.
+    // The queue must be cleared first.
+    void copyFrom(const ESAT_CCSDSPacketQueue& original);
+
+    // Make this queue take over the packets of another packet queue,
+    // which is left with zero capacity.
+    // The queue must be cleared first.
+    void moveFrom(ESAT_CCSDSPacketQueue& original);
 };
 
 #endif /* ESAT_CCSDSPacketQueue_h */
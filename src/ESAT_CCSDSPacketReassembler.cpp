@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_CCSDSPacketReassembler.h"
+
+ESAT_CCSDSPacketReassembler::ESAT_CCSDSPacketReassembler()
+{
+  timeout = 0;
+  pool = nullptr;
+  flush();
+}
+
+ESAT_CCSDSPacketReassembler::ESAT_CCSDSPacketReassembler(ESAT_BufferPool& thePool,
+                                                         const unsigned long theTimeout)
+{
+  timeout = theTimeout;
+  pool = &thePool;
+  flush();
+}
+
+boolean ESAT_CCSDSPacketReassembler::append(Reassembly& reassembly,
+                                            const ESAT_CCSDSPacket& segment)
+{
+  const ESAT_CCSDSPrimaryHeader segmentPrimaryHeader =
+    segment.readPrimaryHeader();
+  // Just fail if the segment comes out of order.
+  if (segmentPrimaryHeader.packetSequenceCount
+      != reassembly.nextPacketSequenceCount)
+  {
+    return false;
+  }
+  ESAT_BufferView segmentData = segment.packetDataView();
+  // Just fail if the segment doesn't fit in the packet being rebuilt.
+  if ((reassembly.packet.capacity() - reassembly.packet.position())
+      < segmentData.length())
+  {
+    return false;
+  }
+  // Normal operation: copy the packet data of the segment.
+  byte chunk[COPY_CHUNK_LENGTH];
+  while (segmentData.availableBytes() > 0)
+  {
+    const size_t chunkLength = segmentData.readBytes(chunk, sizeof(chunk));
+    if (reassembly.packet.write(chunk, chunkLength) < chunkLength)
+    {
+      return false;
+    }
+  }
+  reassembly.nextPacketSequenceCount =
+    (segmentPrimaryHeader.packetSequenceCount + 1)
+    % PACKET_SEQUENCE_COUNT_MODULUS;
+  reassembly.lastSegmentTime = millis();
+  return true;
+}
+
+void ESAT_CCSDSPacketReassembler::drop(Reassembly& reassembly)
+{
+  reassembly.active = false;
+  reassembly.packet = ESAT_CCSDSPacket();
+}
+
+void ESAT_CCSDSPacketReassembler::dropExpiredReassemblies()
+{
+  const unsigned long now = millis();
+  for (byte index = 0; index < MAXIMUM_REASSEMBLIES; index = index + 1)
+  {
+    if (reassemblies[index].active
+        && ((now - reassemblies[index].lastSegmentTime) > timeout))
+    {
+      drop(reassemblies[index]);
+    }
+  }
+}
+
+ESAT_CCSDSPacketReassembler::Reassembly* ESAT_CCSDSPacketReassembler::find(const word applicationProcessIdentifier)
+{
+  for (byte index = 0; index < MAXIMUM_REASSEMBLIES; index = index + 1)
+  {
+    if (reassemblies[index].active
+        && (reassemblies[index].packet.readPrimaryHeader().applicationProcessIdentifier
+            == applicationProcessIdentifier))
+    {
+      return &reassemblies[index];
+    }
+  }
+  // If we didn't find anything, just return nullptr.
+  return nullptr;
+}
+
+ESAT_CCSDSPacketReassembler::Reassembly* ESAT_CCSDSPacketReassembler::findUnused()
+{
+  for (byte index = 0; index < MAXIMUM_REASSEMBLIES; index = index + 1)
+  {
+    if (!reassemblies[index].active)
+    {
+      return &reassemblies[index];
+    }
+  }
+  // If we didn't find anything, just return nullptr.
+  return nullptr;
+}
+
+void ESAT_CCSDSPacketReassembler::flush()
+{
+  for (byte index = 0; index < MAXIMUM_REASSEMBLIES; index = index + 1)
+  {
+    drop(reassemblies[index]);
+  }
+}
+
+byte ESAT_CCSDSPacketReassembler::pending() const
+{
+  byte reassembliesInProgress = 0;
+  for (byte index = 0; index < MAXIMUM_REASSEMBLIES; index = index + 1)
+  {
+    if (reassemblies[index].active)
+    {
+      reassembliesInProgress = reassembliesInProgress + 1;
+    }
+  }
+  return reassembliesInProgress;
+}
+
+boolean ESAT_CCSDSPacketReassembler::reassemble(const ESAT_CCSDSPacket& segment,
+                                                ESAT_CCSDSPacket& packet)
+{
+  dropExpiredReassemblies();
+  const ESAT_CCSDSPrimaryHeader segmentPrimaryHeader =
+    segment.readPrimaryHeader();
+  Reassembly* reassembly =
+    find(segmentPrimaryHeader.applicationProcessIdentifier);
+  switch (segmentPrimaryHeader.sequenceFlags)
+  {
+    case ESAT_CCSDSPrimaryHeader::UNSEGMENTED_USER_DATA:
+      if (!segment.copyTo(packet))
+      {
+        return false;
+      }
+      packet.rewind();
+      return true;
+    case ESAT_CCSDSPrimaryHeader::FIRST_SEGMENT_OF_USER_DATA:
+      // A new first segment restarts the reassembly.
+      if (reassembly != nullptr)
+      {
+        drop(*reassembly);
+      }
+      reassembly = findUnused();
+      // Just fail if we are at the maximum number of reassemblies or
+      // we have no memory for a new one.
+      if ((reassembly == nullptr) || (pool == nullptr))
+      {
+        return false;
+      }
+      reassembly->packet = ESAT_CCSDSPacket(*pool);
+      if (reassembly->packet.capacity() == 0)
+      {
+        drop(*reassembly);
+        return false;
+      }
+      // Normal operation: start a new reassembly.
+      {
+        ESAT_CCSDSPrimaryHeader primaryHeader = segmentPrimaryHeader;
+        primaryHeader.sequenceFlags = primaryHeader.UNSEGMENTED_USER_DATA;
+        reassembly->packet.writePrimaryHeader(primaryHeader);
+      }
+      reassembly->active = true;
+      reassembly->nextPacketSequenceCount =
+        segmentPrimaryHeader.packetSequenceCount;
+      if (!append(*reassembly, segment))
+      {
+        drop(*reassembly);
+      }
+      return false;
+    case ESAT_CCSDSPrimaryHeader::CONTINUATION_SEGMENT_OF_USER_DATA:
+      // Just fail if we aren't rebuilding the packet.
+      if (reassembly == nullptr)
+      {
+        return false;
+      }
+      if (!append(*reassembly, segment))
+      {
+        drop(*reassembly);
+      }
+      return false;
+    case ESAT_CCSDSPrimaryHeader::LAST_SEGMENT_OF_USER_DATA:
+      // Just fail if we aren't rebuilding the packet.
+      if (reassembly == nullptr)
+      {
+        return false;
+      }
+      if (!append(*reassembly, segment))
+      {
+        drop(*reassembly);
+        return false;
+      }
+      // Normal operation: the packet is complete.
+      {
+        const boolean correctCopy = reassembly->packet.copyTo(packet);
+        drop(*reassembly);
+        if (!correctCopy)
+        {
+          return false;
+        }
+      }
+      packet.rewind();
+      return true;
+    default:
+      return false;
+  }
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_CCSDSPacketReassembler_h
+#define ESAT_CCSDSPacketReassembler_h
+
+#include <Arduino.h>
+#include "ESAT_BufferPool.h"
+#include "ESAT_BufferView.h"
+#include "ESAT_CCSDSPacket.h"
+
+// Rebuild CCSDS space packets from the segments made by
+// ESAT_CCSDSPacketSegmenter.
+// Segments of packets with different application process
+// identifiers can arrive interleaved: each application process
+// identifier has its own reassembly in progress, up to
+// MAXIMUM_REASSEMBLIES at the same time.  Each reassembly draws the
+// packet data field of the packet being rebuilt from a pool, so the
+// memory taken by reassemblies is bounded by the pool: the pool block
+// capacity is the maximum packet data length of a rebuilt packet and
+// the number of blocks is the maximum number of reassemblies that can
+// be in progress.
+// A reassembly is dropped when its segments come out of order (with
+// a gap in the packet sequence count), when the rebuilt packet data
+// would overflow its pool block, when a new first segment with the
+// same application process identifier arrives, or when no segment
+// arrives for longer than the timeout.
+class ESAT_CCSDSPacketReassembler
+{
+  public:
+    // Maximum number of reassemblies in progress at the same time.
+    static const byte MAXIMUM_REASSEMBLIES = 4;
+
+    // Instantiate an empty reassembler.
+    // An empty reassembler only passes unsegmented packets through.
+    ESAT_CCSDSPacketReassembler();
+
+    // Instantiate a reassembler that takes the memory for the packets
+    // being rebuilt from the given pool and drops reassemblies when no
+    // segment arrives for more than the given timeout (in
+    // milliseconds).
+    // The pool must outlive the reassembler.
+    ESAT_CCSDSPacketReassembler(ESAT_BufferPool& pool,
+                                unsigned long timeout);
+
+    // Drop all reassemblies in progress.
+    void flush();
+
+    // Return the number of reassemblies in progress.
+    byte pending() const;
+
+    // Process a segment.
+    // Return true when the segment completes a packet, which is then
+    // copied to the given packet object; otherwise return false.
+    // Unsegmented packets are complete by themselves, so they are
+    // just copied to the given packet object.
+    // Fail if the packet object is too small for the rebuilt packet.
+    // The read/write pointer of the rebuilt packet goes to the start
+    // of the packet data field.
+    boolean reassemble(const ESAT_CCSDSPacket& segment,
+                       ESAT_CCSDSPacket& packet);
+
+  private:
+    // Packet sequence counts go from 0 to this value minus 1.
+    static const word PACKET_SEQUENCE_COUNT_MODULUS = 0x4000;
+
+    // Number of bytes copied at once from the segments to the packets
+    // being rebuilt.
+    static const byte COPY_CHUNK_LENGTH = 32;
+
+    // Reassembly in progress.
+    struct Reassembly
+    {
+      // True when the reassembly is in progress.
+      boolean active;
+
+      // Expected packet sequence count of the next segment.
+      word nextPacketSequenceCount;
+
+      // Time (in uptime milliseconds) of arrival of the last segment.
+      unsigned long lastSegmentTime;
+
+      // Packet being rebuilt.
+      ESAT_CCSDSPacket packet;
+    };
+
+    // Drop reassemblies that waited longer than this time (in
+    // milliseconds) for their next segment.
+    unsigned long timeout;
+
+    // Pool for the packet data of the packets being rebuilt.
+    ESAT_BufferPool* pool;
+
+    // Reassemblies in progress.
+    Reassembly reassemblies[MAXIMUM_REASSEMBLIES];
+
+    // Append the packet data of a segment to the packet being rebuilt
+    // by a reassembly and expect the next segment.
+    // Return true on success; otherwise return false.
+    boolean append(Reassembly& reassembly,
+                   const ESAT_CCSDSPacket& segment);
+
+    // Drop a reassembly and give its memory back to the pool.
+    void drop(Reassembly& reassembly);
+
+    // Drop the reassemblies that timed out.
+    void dropExpiredReassemblies();
+
+    // Return the reassembly in progress for the given application
+    // process identifier or nullptr if there is none.
+    Reassembly* find(word applicationProcessIdentifier);
+
+    // Return an unused reassembly or nullptr if there is none.
+    Reassembly* findUnused();
+};
+
+#endif /* ESAT_CCSDSPacketReassembler_h */
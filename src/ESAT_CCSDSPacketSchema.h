@@ -0,0 +1,499 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_CCSDSPacketSchema_h
+#define ESAT_CCSDSPacketSchema_h
+
+#include <Arduino.h>
+#include "ESAT_CCSDSPacket.h"
+#include "ESAT_CCSDSSecondaryHeader.h"
+#include "ESAT_StaticCCSDSPacket.h"
+#include "ESAT_Timestamp.h"
+#include "ESAT_Util.h"
+
+// Compile-time layouts of the user data field of telemetry and
+// telecommand packets.
+//
+// Declare the values of a packet as a plain structure and the layout
+// as the list of its fields, in the order they go in the packet:
+//
+//   struct Housekeeping
+//   {
+//     word voltage;
+//     int temperature;
+//     float current;
+//   };
+//
+//   typedef ESAT_CCSDSPacketSchema<Housekeeping,
+//                                  ESAT_CCSDS_FIELD(Housekeeping, voltage),
+//                                  ESAT_CCSDS_FIELD(Housekeeping, temperature),
+//                                  ESAT_CCSDS_FIELD(Housekeeping, current)>
+//     HousekeepingSchema;
+//
+// HousekeepingSchema::LENGTH is then the exact length in bytes of the
+// encoded values, known at compile time, and HousekeepingSchema::write()
+// and HousekeepingSchema::read() move the whole structure to and from
+// a packet with a single bulk write or read.  The offset of each field
+// is also computed at compile time, so encoding and decoding are plain
+// stores and loads at fixed positions of a byte array, without a
+// Stream call per field.
+//
+// Each field is encoded exactly as the corresponding
+// ESAT_CCSDSPacket::writeX() method does:
+// - boolean: 1 byte (1 for true, 0 for false);
+// - byte, char, signed char: 1 byte;
+// - word, int, short and their unsigned variants: 2 bytes;
+// - long, unsigned long, float: 4 bytes;
+// - ESAT_Timestamp: 7 bytes (binary coded decimal);
+// - arrays of any of the above: the elements one after the other.
+// Integer types always take the number of bytes of ESAT_CCSDSPacket's
+// methods (int is 2 bytes, long is 4 bytes), so a layout is the same
+// on every platform regardless of the native size of the types.
+
+
+// Encoder and decoder of one field type.
+// There are specializations for each supported field type; using any
+// other type in a field list fails at compile time.
+template <class Type>
+class ESAT_CCSDSFieldCodec
+{
+  static_assert(sizeof(Type) == 0,
+                "Unsupported field type in a CCSDS packet schema.");
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<bool>
+{
+  public:
+    static const unsigned long LENGTH = 1;
+
+    static void decode(const byte buffer[], bool& datum)
+    {
+      datum = (buffer[0] != 0);
+    }
+
+    static void encode(const bool datum, byte buffer[])
+    {
+      // Encode true as one and false as zero.
+      if (datum)
+      {
+        buffer[0] = 1;
+      }
+      else
+      {
+        buffer[0] = 0;
+      }
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<unsigned char>
+{
+  public:
+    static const unsigned long LENGTH = 1;
+
+    static void decode(const byte buffer[], unsigned char& datum)
+    {
+      datum = buffer[0];
+    }
+
+    static void encode(const unsigned char datum, byte buffer[])
+    {
+      buffer[0] = datum;
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<signed char>
+{
+  public:
+    static const unsigned long LENGTH = 1;
+
+    static void decode(const byte buffer[], signed char& datum)
+    {
+      datum = ESAT_Util.byteToChar(buffer[0]);
+    }
+
+    static void encode(const signed char datum, byte buffer[])
+    {
+      buffer[0] = ESAT_Util.charToByte(datum);
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<char>
+{
+  public:
+    static const unsigned long LENGTH = 1;
+
+    static void decode(const byte buffer[], char& datum)
+    {
+      datum = (char) buffer[0];
+    }
+
+    static void encode(const char datum, byte buffer[])
+    {
+      buffer[0] = (byte) datum;
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<unsigned short>
+{
+  public:
+    static const unsigned long LENGTH = 2;
+
+    static void decode(const byte buffer[], unsigned short& datum)
+    {
+      datum = (((unsigned short) buffer[0]) << 8) | buffer[1];
+    }
+
+    static void encode(const unsigned short datum, byte buffer[])
+    {
+      buffer[0] = datum >> 8;
+      buffer[1] = datum;
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<unsigned int>
+{
+  public:
+    static const unsigned long LENGTH = 2;
+
+    static void decode(const byte buffer[], unsigned int& datum)
+    {
+      unsigned short bits;
+      ESAT_CCSDSFieldCodec<unsigned short>::decode(buffer, bits);
+      datum = bits;
+    }
+
+    static void encode(const unsigned int datum, byte buffer[])
+    {
+      ESAT_CCSDSFieldCodec<unsigned short>::encode(datum, buffer);
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<short>
+{
+  public:
+    static const unsigned long LENGTH = 2;
+
+    static void decode(const byte buffer[], short& datum)
+    {
+      unsigned short bits;
+      ESAT_CCSDSFieldCodec<unsigned short>::decode(buffer, bits);
+      datum = ESAT_Util.wordToInt(bits);
+    }
+
+    static void encode(const short datum, byte buffer[])
+    {
+      ESAT_CCSDSFieldCodec<unsigned short>::encode(ESAT_Util.intToWord(datum),
+                                                   buffer);
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<int>
+{
+  public:
+    static const unsigned long LENGTH = 2;
+
+    static void decode(const byte buffer[], int& datum)
+    {
+      unsigned short bits;
+      ESAT_CCSDSFieldCodec<unsigned short>::decode(buffer, bits);
+      datum = ESAT_Util.wordToInt(bits);
+    }
+
+    static void encode(const int datum, byte buffer[])
+    {
+      ESAT_CCSDSFieldCodec<unsigned short>::encode(ESAT_Util.intToWord(datum),
+                                                   buffer);
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<unsigned long>
+{
+  public:
+    static const unsigned long LENGTH = 4;
+
+    static void decode(const byte buffer[], unsigned long& datum)
+    {
+      datum =
+        (((unsigned long) buffer[0]) << 24)
+        | (((unsigned long) buffer[1]) << 16)
+        | (((unsigned long) buffer[2]) << 8)
+        | ((unsigned long) buffer[3]);
+    }
+
+    static void encode(const unsigned long datum, byte buffer[])
+    {
+      buffer[0] = datum >> 24;
+      buffer[1] = datum >> 16;
+      buffer[2] = datum >> 8;
+      buffer[3] = datum;
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<long>
+{
+  public:
+    static const unsigned long LENGTH = 4;
+
+    static void decode(const byte buffer[], long& datum)
+    {
+      unsigned long bits;
+      ESAT_CCSDSFieldCodec<unsigned long>::decode(buffer, bits);
+      datum = ESAT_Util.unsignedLongToLong(bits);
+    }
+
+    static void encode(const long datum, byte buffer[])
+    {
+      const unsigned long bits = ESAT_Util.longToUnsignedLong(datum);
+      ESAT_CCSDSFieldCodec<unsigned long>::encode(bits, buffer);
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<float>
+{
+  public:
+    static const unsigned long LENGTH = 4;
+
+    static void decode(const byte buffer[], float& datum)
+    {
+      unsigned long bits;
+      ESAT_CCSDSFieldCodec<unsigned long>::decode(buffer, bits);
+      datum = ESAT_Util.unsignedLongToFloat(bits);
+    }
+
+    static void encode(const float datum, byte buffer[])
+    {
+      const unsigned long bits = ESAT_Util.floatToUnsignedLong(datum);
+      ESAT_CCSDSFieldCodec<unsigned long>::encode(bits, buffer);
+    }
+};
+
+template <>
+class ESAT_CCSDSFieldCodec<ESAT_Timestamp>
+{
+  public:
+    static const unsigned long LENGTH = ESAT_Timestamp::LENGTH;
+
+    static void decode(const byte buffer[], ESAT_Timestamp& datum)
+    {
+      datum.readFrom(buffer);
+    }
+
+    static void encode(const ESAT_Timestamp& datum, byte buffer[])
+    {
+      datum.writeTo(buffer);
+    }
+};
+
+template <class Type, size_t ELEMENTS>
+class ESAT_CCSDSFieldCodec<Type[ELEMENTS]>
+{
+  public:
+    static const unsigned long LENGTH =
+      ELEMENTS * ESAT_CCSDSFieldCodec<Type>::LENGTH;
+
+    static void decode(const byte buffer[], Type (&data)[ELEMENTS])
+    {
+      for (size_t index = 0; index < ELEMENTS; index = index + 1)
+      {
+        ESAT_CCSDSFieldCodec<Type>::decode(
+          &buffer[index * ESAT_CCSDSFieldCodec<Type>::LENGTH],
+          data[index]);
+      }
+    }
+
+    static void encode(const Type (&data)[ELEMENTS], byte buffer[])
+    {
+      for (size_t index = 0; index < ELEMENTS; index = index + 1)
+      {
+        ESAT_CCSDSFieldCodec<Type>::encode(
+          data[index],
+          &buffer[index * ESAT_CCSDSFieldCodec<Type>::LENGTH]);
+      }
+    }
+};
+
+
+// One field of a packet schema: the member MEMBER, of type Type, of
+// the structure Struct.
+// ESAT_CCSDS_FIELD(Struct, member) is a shorter way of writing
+// ESAT_CCSDSField<Struct, decltype(Struct::member), &Struct::member>.
+template <class Struct, class Type, Type Struct::*MEMBER>
+class ESAT_CCSDSField
+{
+  public:
+    // Length of the encoded field in bytes.
+    static const unsigned long LENGTH = ESAT_CCSDSFieldCodec<Type>::LENGTH;
+
+    // Decode the field from the start of the buffer.
+    static void decode(const byte buffer[], Struct& values)
+    {
+      ESAT_CCSDSFieldCodec<Type>::decode(buffer, values.*MEMBER);
+    }
+
+    // Encode the field at the start of the buffer.
+    static void encode(const Struct& values, byte buffer[])
+    {
+      ESAT_CCSDSFieldCodec<Type>::encode(values.*MEMBER, buffer);
+    }
+};
+
+#define ESAT_CCSDS_FIELD(Struct, member) \
+  ESAT_CCSDSField<Struct, decltype(Struct::member), &Struct::member>
+
+
+// Fields of a packet schema from the given compile-time offset on.
+// This is an implementation detail of ESAT_CCSDSPacketSchema.
+template <unsigned long OFFSET, class Struct, class... Fields>
+class ESAT_CCSDSFieldList;
+
+template <unsigned long OFFSET, class Struct>
+class ESAT_CCSDSFieldList<OFFSET, Struct>
+{
+  public:
+    static const unsigned long END = OFFSET;
+
+    static void decode(const byte buffer[], Struct& values)
+    {
+      (void) buffer;
+      (void) values;
+    }
+
+    static void encode(const Struct& values, byte buffer[])
+    {
+      (void) values;
+      (void) buffer;
+    }
+};
+
+template <unsigned long OFFSET, class Struct, class Field, class... Fields>
+class ESAT_CCSDSFieldList<OFFSET, Struct, Field, Fields...>
+{
+  public:
+    // The next field goes right after this one.
+    typedef ESAT_CCSDSFieldList<OFFSET + Field::LENGTH, Struct, Fields...>
+      Rest;
+
+    static const unsigned long END = Rest::END;
+
+    static void decode(const byte buffer[], Struct& values)
+    {
+      Field::decode(&buffer[OFFSET], values);
+      Rest::decode(buffer, values);
+    }
+
+    static void encode(const Struct& values, byte buffer[])
+    {
+      Field::encode(values, &buffer[OFFSET]);
+      Rest::encode(values, buffer);
+    }
+};
+
+
+// Layout of the user data field of a packet: a sequence of members of
+// the structure Struct.  See the beginning of this file for an example.
+template <class Struct, class... Fields>
+class ESAT_CCSDSPacketSchema
+{
+  public:
+    // Length of the encoded values in bytes.
+    static const unsigned long LENGTH =
+      ESAT_CCSDSFieldList<0, Struct, Fields...>::END;
+
+    static_assert(LENGTH > 0, "A packet schema must have some fields.");
+
+    // Decode the values from a buffer of LENGTH bytes.
+    static void decode(const byte buffer[], Struct& values)
+    {
+      ESAT_CCSDSFieldList<0, Struct, Fields...>::decode(buffer, values);
+    }
+
+    // Encode the values into a buffer of LENGTH bytes.
+    static void encode(const Struct& values, byte buffer[])
+    {
+      ESAT_CCSDSFieldList<0, Struct, Fields...>::encode(values, buffer);
+    }
+
+    // Read the values from the current position of a packet.
+    // Return true on success; otherwise return false.
+    // Fail without reading anything if there are less than LENGTH
+    // bytes left to read.
+    static boolean read(ESAT_CCSDSPacket& packet, Struct& values)
+    {
+      // Just fail if the packet is too short.
+      if (packet.availableBytesToRead() < LENGTH)
+      {
+        return false;
+      }
+      // Normal operation: one bulk read and a decode from fixed
+      // offsets.
+      byte buffer[LENGTH];
+      if (packet.readBytes(buffer, LENGTH) < LENGTH)
+      {
+        return false;
+      }
+      decode(buffer, values);
+      return true;
+    }
+
+    // Write the values at the current position of a packet.
+    // Return true on success; otherwise return false.
+    // Fail without writing anything if there is room for less than
+    // LENGTH bytes.
+    static boolean write(ESAT_CCSDSPacket& packet, const Struct& values)
+    {
+      // Just fail if the packet is too short.
+      if (packet.capacity() - packet.position() < LENGTH)
+      {
+        return false;
+      }
+      // Normal operation: an encode into fixed offsets and one bulk
+      // write.
+      byte buffer[LENGTH];
+      encode(values, buffer);
+      return (packet.write(buffer, LENGTH) == LENGTH);
+    }
+
+    // Write the values at the current position of a static packet.
+    // Same as write(ESAT_CCSDSPacket&, const Struct&), but fail at
+    // compile time if the secondary header and the values don't fit
+    // in the packet data field.
+    template <unsigned long PACKET_DATA_CAPACITY>
+    static boolean write(ESAT_StaticCCSDSPacket<PACKET_DATA_CAPACITY>& packet,
+                         const Struct& values)
+    {
+      static_assert(ESAT_CCSDSSecondaryHeader::LENGTH + LENGTH
+                    <= PACKET_DATA_CAPACITY,
+                    "The packet data capacity is too small for the schema.");
+      return write((ESAT_CCSDSPacket&) packet, values);
+    }
+};
+
+#endif /* ESAT_CCSDSPacketSchema_h */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_CCSDSPacketSegmenter.h"
+
+ESAT_CCSDSPacketSegmenter::ESAT_CCSDSPacketSegmenter()
+{
+  maximumSegmentDataLength = 0;
+  nextSegment = 0;
+}
+
+ESAT_CCSDSPacketSegmenter::ESAT_CCSDSPacketSegmenter(const ESAT_CCSDSPacket& packet,
+                                                     const unsigned long theMaximumSegmentDataLength)
+{
+  maximumSegmentDataLength = theMaximumSegmentDataLength;
+  nextSegment = 0;
+  packetData = packet.packetDataView();
+  primaryHeader = packet.readPrimaryHeader();
+}
+
+unsigned long ESAT_CCSDSPacketSegmenter::available() const
+{
+  return segments() - nextSegment;
+}
+
+boolean ESAT_CCSDSPacketSegmenter::read(ESAT_CCSDSPacket& segment)
+{
+  // Just fail when there are no more segments.
+  if (available() == 0)
+  {
+    return false;
+  }
+  const unsigned long offset = nextSegment * maximumSegmentDataLength;
+  const unsigned long segmentDataLength =
+    min(packetData.length() - offset, maximumSegmentDataLength);
+  // Just fail if the segment doesn't fit in the segment packet.
+  if (segment.capacity() < segmentDataLength)
+  {
+    return false;
+  }
+  // Normal operation: fill the primary header of the segment and copy
+  // its piece of the packet data.
+  ESAT_CCSDSPrimaryHeader segmentPrimaryHeader = primaryHeader;
+  if (segments() == 1)
+  {
+    segmentPrimaryHeader.sequenceFlags =
+      segmentPrimaryHeader.UNSEGMENTED_USER_DATA;
+  }
+  else if (nextSegment == 0)
+  {
+    segmentPrimaryHeader.sequenceFlags =
+      segmentPrimaryHeader.FIRST_SEGMENT_OF_USER_DATA;
+  }
+  else
+  {
+    if (nextSegment == (segments() - 1))
+    {
+      segmentPrimaryHeader.sequenceFlags =
+        segmentPrimaryHeader.LAST_SEGMENT_OF_USER_DATA;
+    }
+    else
+    {
+      segmentPrimaryHeader.sequenceFlags =
+        segmentPrimaryHeader.CONTINUATION_SEGMENT_OF_USER_DATA;
+    }
+    segmentPrimaryHeader.secondaryHeaderFlag =
+      segmentPrimaryHeader.SECONDARY_HEADER_IS_NOT_PRESENT;
+  }
+  segmentPrimaryHeader.packetSequenceCount =
+    (primaryHeader.packetSequenceCount + nextSegment)
+    % PACKET_SEQUENCE_COUNT_MODULUS;
+  segment.flush();
+  segment.writePrimaryHeader(segmentPrimaryHeader);
+  (void) packetData.seek(offset);
+  byte chunk[COPY_CHUNK_LENGTH];
+  unsigned long bytesToCopy = segmentDataLength;
+  while (bytesToCopy > 0)
+  {
+    const size_t chunkLength =
+      packetData.readBytes(chunk,
+                           min(bytesToCopy, (unsigned long) sizeof(chunk)));
+    if (chunkLength == 0)
+    {
+      break;
+    }
+    (void) segment.write(chunk, chunkLength);
+    bytesToCopy = bytesToCopy - chunkLength;
+  }
+  segment.rewind();
+  nextSegment = nextSegment + 1;
+  return true;
+}
+
+unsigned long ESAT_CCSDSPacketSegmenter::segments() const
+{
+  if (maximumSegmentDataLength == 0)
+  {
+    return 0;
+  }
+  if (packetData.length() == 0)
+  {
+    return 0;
+  }
+  return
+    (packetData.length() + maximumSegmentDataLength - 1)
+    / maximumSegmentDataLength;
+}
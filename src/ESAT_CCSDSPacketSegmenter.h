@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_CCSDSPacketSegmenter_h
+#define ESAT_CCSDSPacketSegmenter_h
+
+#include <Arduino.h>
+#include "ESAT_BufferView.h"
+#include "ESAT_CCSDSPacket.h"
+
+// Split large CCSDS space packets into segments that fit in packets
+// of small capacity, so that small fixed packet buffers, I2C
+// transfers and queue slots can carry large payloads (such as images
+// or memory dumps).  ESAT_CCSDSPacketReassembler rebuilds the
+// original packets from their segments.
+// The packet data field of the original packet is cut into pieces of
+// at most a given length.  Each piece goes in the packet data field
+// of a segment with the same packet version number, packet type and
+// application process identifier as the original packet, and with
+// the sequence flags set to FIRST_SEGMENT_OF_USER_DATA,
+// CONTINUATION_SEGMENT_OF_USER_DATA or LAST_SEGMENT_OF_USER_DATA.
+// Only the first segment keeps the secondary header flag of the
+// original packet, as only its packet data starts with the secondary
+// header.  The segments take consecutive packet sequence counts
+// starting at the one of the original packet, so the application
+// process must advance its own packet sequence count by the number
+// of segments.
+// Packets that fit in one segment go unchanged, as unsegmented user
+// data.
+class ESAT_CCSDSPacketSegmenter
+{
+  public:
+    // Instantiate an empty segmenter.
+    // An empty segmenter doesn't produce segments.
+    ESAT_CCSDSPacketSegmenter();
+
+    // Instantiate a segmenter that splits the given packet into
+    // segments with packet data fields of at most
+    // maximumSegmentDataLength bytes.
+    // The segmenter shares the memory of the packet data (see
+    // ESAT_BufferView), so it doesn't copy it.
+    ESAT_CCSDSPacketSegmenter(const ESAT_CCSDSPacket& packet,
+                              unsigned long maximumSegmentDataLength);
+
+    // Return the number of segments still to be read.
+    unsigned long available() const;
+
+    // Write the next segment to the given packet.
+    // Return true on success; otherwise return false.
+    // Fail without moving to the next segment if there are no more
+    // segments or the packet data capacity of the segment packet is
+    // too small.
+    boolean read(ESAT_CCSDSPacket& segment);
+
+    // Return the total number of segments of the packet.
+    unsigned long segments() const;
+
+  private:
+    // Number of bytes copied at once from the original packet to the
+    // segments.
+    static const byte COPY_CHUNK_LENGTH = 32;
+
+    // Packet sequence counts go from 0 to this value minus 1.
+    static const word PACKET_SEQUENCE_COUNT_MODULUS = 0x4000;
+
+    // Maximum length of the packet data field of the segments.
+    unsigned long maximumSegmentDataLength;
+
+    // Index of the next segment to be read.
+    unsigned long nextSegment;
+
+    // Packet data field of the original packet.
+    ESAT_BufferView packetData;
+
+    // Primary header of the original packet.
+    ESAT_CCSDSPrimaryHeader primaryHeader;
+};
+
+#endif /* ESAT_CCSDSPacketSegmenter_h */
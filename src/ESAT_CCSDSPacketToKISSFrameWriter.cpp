@@ -19,72 +19,117 @@
  */
 
 #include "ESAT_CCSDSPacketToKISSFrameWriter.h"
-#include "ESAT_KISSStream.h"
+#include "ESAT_MemoryAccounting.h"
 
 ESAT_CCSDSPacketToKISSFrameWriter::ESAT_CCSDSPacketToKISSFrameWriter()
 {
   backendStream = nullptr;
+  frameBufferCapacity = 0;
 }
 
 ESAT_CCSDSPacketToKISSFrameWriter::ESAT_CCSDSPacketToKISSFrameWriter(Stream& backend)
 {
   backendStream = &backend;
+  frameBufferCapacity = 0;
 }
 
-boolean ESAT_CCSDSPacketToKISSFrameWriter::bufferedWrite(ESAT_CCSDSPacket packet)
+ESAT_CCSDSPacketToKISSFrameWriter::ESAT_CCSDSPacketToKISSFrameWriter(Stream& backend,
+                                                                     const unsigned long theFrameBufferCapacity)
 {
-  if (backendStream)
+  ESAT_MemoryAccountingScope accountingScope(ESAT_MemoryAccounting.KISS_STREAM);
+  backendStream = &backend;
+  frameBufferCapacity = theFrameBufferCapacity;
+  frameWriter = ESAT_KISSStream(backend, frameBufferCapacity);
+}
+
+ESAT_CCSDSPacketToKISSFrameWriter::ESAT_CCSDSPacketToKISSFrameWriter(Stream& backend,
+                                                                     byte frameBuffer[],
+                                                                     const unsigned long theFrameBufferCapacity)
+{
+  backendStream = &backend;
+  frameBufferCapacity = theFrameBufferCapacity;
+  frameWriter = ESAT_KISSStream(backend, frameBuffer, frameBufferCapacity);
+}
+
+boolean ESAT_CCSDSPacketToKISSFrameWriter::bufferedWrite(const ESAT_CCSDSPacket& packet)
+{
+  return bufferedWrite(packet.bufferChain());
+}
+
+boolean ESAT_CCSDSPacketToKISSFrameWriter::bufferedWrite(const ESAT_BufferChain& chain)
+{
+  // Just fail if there is no backend stream.
+  if (!backendStream)
+  {
+    return false;
+  }
+  // Without a frame buffer, encode the frame into a temporary buffer
+  // of the exact frame length.
+  if (frameBufferCapacity == 0)
   {
-    const unsigned long capacity =
-      ESAT_KISSStream::frameLength(packet.length());
-    ESAT_KISSStream writer(*backendStream, capacity);
-    const size_t beginBytesWritten = writer.beginFrame();
-    if (beginBytesWritten < writer.FRAME_BEGIN_LENGTH)
-    {
-      return false;
-    }
-    const boolean correctPacketWrite = packet.writeTo(writer);
-    if (!correctPacketWrite)
-    {
-      return false;
-    }
-    const boolean endBytesWritten = writer.endFrame();
-    if (endBytesWritten < writer.FRAME_END_LENGTH)
-    {
-      return false;
-    }
-    return true;
+    ESAT_KISSStream writer(*backendStream, frameLength(chain));
+    return write(writer, chain);
   }
-  else
+  // Normal operation: encode the frame into the frame buffer when it
+  // fits even in the worst case, or when its exact length fits;
+  // otherwise write it unbuffered rather than allocating memory.
+  if ((ESAT_KISSStream::frameLength(chain.length()) <= frameBufferCapacity)
+      || (frameLength(chain) <= frameBufferCapacity))
+  {
+    return write(frameWriter, chain);
+  }
+  return unbufferedWrite(chain);
+}
+
+unsigned long ESAT_CCSDSPacketToKISSFrameWriter::frameLength(const ESAT_BufferChain& chain)
+{
+  unsigned long length =
+    ESAT_KISSStream::FRAME_BEGIN_LENGTH + ESAT_KISSStream::FRAME_END_LENGTH;
+  for (byte segment = 0; segment < chain.segments(); segment++)
+  {
+    length =
+      length
+      + ESAT_KISSStream::escapedDataLength(chain.segment(segment),
+                                           chain.segmentLength(segment));
+  }
+  return length;
+}
+
+boolean ESAT_CCSDSPacketToKISSFrameWriter::unbufferedWrite(const ESAT_CCSDSPacket& packet)
+{
+  return unbufferedWrite(packet.bufferChain());
+}
+
+boolean ESAT_CCSDSPacketToKISSFrameWriter::unbufferedWrite(const ESAT_BufferChain& chain)
+{
+  // Just fail if there is no backend stream.
+  if (!backendStream)
   {
     return false;
   }
+  // Normal operation: encode the frame straight to the backend
+  // stream.
+  ESAT_KISSStream writer(*backendStream);
+  return write(writer, chain);
 }
 
-boolean ESAT_CCSDSPacketToKISSFrameWriter::unbufferedWrite(ESAT_CCSDSPacket packet)
+boolean ESAT_CCSDSPacketToKISSFrameWriter::write(ESAT_KISSStream& writer,
+                                                 const ESAT_BufferChain& chain)
 {
-  if (backendStream)
+  const size_t beginBytesWritten = writer.beginFrame();
+  if (beginBytesWritten < writer.FRAME_BEGIN_LENGTH)
   {
-    ESAT_KISSStream writer(*backendStream);
-    const size_t beginBytesWritten = writer.beginFrame();
-    if (beginBytesWritten < writer.FRAME_BEGIN_LENGTH)
-    {
-      return false;
-    }
-    const boolean correctPacketWrite = packet.writeTo(writer);
-    if (!correctPacketWrite)
-    {
-      return false;
-    }
-    const boolean endBytesWritten = writer.endFrame();
-    if (endBytesWritten < writer.FRAME_END_LENGTH)
-    {
-      return false;
-    }
-    return true;
+    return false;
+  }
+  const boolean correctChainWrite = chain.writeTo(writer);
+  if (!correctChainWrite)
+  {
+    return false;
   }
-  else
+  const boolean endBytesWritten = writer.endFrame();
+  if (endBytesWritten < writer.FRAME_END_LENGTH)
   {
     return false;
   }
+  return true;
 }
@@ -22,7 +22,9 @@
 #define ESAT_CCSDSPacketToKISSFrameWriter_h
 
 #include <Arduino.h>
+#include "ESAT_BufferChain.h"
 #include "ESAT_CCSDSPacket.h"
+#include "ESAT_KISSStream.h"
 
 // CCSDS-to-KISS writer.
 // Write CCSDS Space Packets in KISS frames to a backend Stream.
@@ -36,25 +38,74 @@ class ESAT_CCSDSPacketToKISSFrameWriter
 
     // Instantiate a CCSDS-to-KISS writer that will write data to
     // this backend stream.
+    // Buffered writes will allocate a temporary frame buffer.
     ESAT_CCSDSPacketToKISSFrameWriter(Stream& backend);
 
+    // Instantiate a CCSDS-to-KISS writer that will write data to
+    // this backend stream.
+    // Buffered writes will use a frame buffer of given capacity,
+    // allocated once here and reused for every frame.
+    ESAT_CCSDSPacketToKISSFrameWriter(Stream& backend,
+                                      unsigned long frameBufferCapacity);
+
+    // Instantiate a CCSDS-to-KISS writer that will write data to
+    // this backend stream.
+    // Buffered writes will use the given array of given capacity as
+    // frame buffer.
+    ESAT_CCSDSPacketToKISSFrameWriter(Stream& backend,
+                                      byte frameBuffer[],
+                                      unsigned long frameBufferCapacity);
+
     // Write the given packet in a KISS frame to the backend stream.
     // The write will be buffered and the frame will be written in one
     // operation, which may be faster with some streams, but it will
     // consume more memory than an unbuffered write.
+    // Writers with a frame buffer encode the frame into it and fall
+    // back to an unbuffered write when the frame doesn't fit in it;
+    // other writers allocate a temporary frame buffer of the exact
+    // frame length.
+    // Return true on success; otherwise return false.
+    boolean bufferedWrite(const ESAT_CCSDSPacket& packet);
+
+    // Write the contents of the given buffer chain in a KISS frame to
+    // the backend stream.
+    // The write will be buffered as with bufferedWrite(packet).
     // Return true on success; otherwise return false.
-    boolean bufferedWrite(ESAT_CCSDSPacket packet);
+    boolean bufferedWrite(const ESAT_BufferChain& chain);
 
     // Write the given packet in a KISS frame to the backend stream.
     // The write will be unbuffered and the frame will be written byte
     // by byte, which may be slower with some streams, but it will
     // consume less memory than a buffered write.
     // Return true on success; otherwise return false.
-    boolean unbufferedWrite(ESAT_CCSDSPacket packet);
+    boolean unbufferedWrite(const ESAT_CCSDSPacket& packet);
+
+    // Write the contents of the given buffer chain in a KISS frame to
+    // the backend stream.
+    // The write will be unbuffered as with unbufferedWrite(packet).
+    // Return true on success; otherwise return false.
+    boolean unbufferedWrite(const ESAT_BufferChain& chain);
 
   private:
     // Write frames to this stream.
     Stream* backendStream;
+
+    // Capacity of the frame buffer of frameWriter (0 when there is
+    // no frame buffer).
+    unsigned long frameBufferCapacity;
+
+    // KISS stream reused by buffered writes, with the frame buffer.
+    ESAT_KISSStream frameWriter;
+
+    // Return the exact length of the KISS frame with the contents of
+    // the given buffer chain.
+    static unsigned long frameLength(const ESAT_BufferChain& chain);
+
+    // Write the contents of the given buffer chain in a KISS frame
+    // with the given KISS stream.
+    // Return true on success; otherwise return false.
+    static boolean write(ESAT_KISSStream& writer,
+                         const ESAT_BufferChain& chain);
 };
 
 #endif /* ESAT_CCSDSPacketToKISSFrameWriter_h */
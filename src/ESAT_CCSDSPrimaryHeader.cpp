@@ -19,7 +19,6 @@
  */
 
 #include "ESAT_CCSDSPrimaryHeader.h"
-#include "ESAT_Buffer.h"
 
 size_t ESAT_CCSDSPrimaryHeader::printTo(Print& output) const
 {
@@ -152,21 +151,19 @@ size_t ESAT_CCSDSPrimaryHeader::printTo(Print& output) const
 boolean ESAT_CCSDSPrimaryHeader::readFrom(Stream& input)
 {
   byte octets[LENGTH];
-  ESAT_Buffer data(octets, sizeof(octets));
-  const boolean correctRead = data.readFrom(input, sizeof(octets));
-  if (!correctRead)
+  const size_t bytesRead = input.readBytes((char*) octets, sizeof(octets));
+  if (bytesRead != sizeof(octets))
   {
     return false;
   }
-  const byte firstByte = data.read();
-  const byte secondByte = data.read();
-  const word firstWord = word(firstByte, secondByte);
-  const byte thirdByte = data.read();
-  const byte fourthByte = data.read();
-  const word secondWord = word(thirdByte, fourthByte);
-  const byte fifthByte = data.read();
-  const byte sixthByte = data.read();
-  const word thirdWord = word(fifthByte, sixthByte);
+  return readFrom(octets);
+}
+
+boolean ESAT_CCSDSPrimaryHeader::readFrom(const byte octets[])
+{
+  const word firstWord = word(octets[0], octets[1]);
+  const word secondWord = word(octets[2], octets[3]);
+  const word thirdWord = word(octets[4], octets[5]);
   packetVersionNumber =
     (firstWord & PACKET_VERSION_NUMBER_MASK)
     >> PACKET_VERSION_NUMBER_OFFSET;
@@ -193,6 +190,13 @@ boolean ESAT_CCSDSPrimaryHeader::readFrom(Stream& input)
 }
 
 boolean ESAT_CCSDSPrimaryHeader::writeTo(Stream& output) const
+{
+  byte octets[LENGTH];
+  writeTo(octets);
+  return output.write(octets, sizeof(octets)) == sizeof(octets);
+}
+
+void ESAT_CCSDSPrimaryHeader::writeTo(byte octets[]) const
 {
   const word firstWord =
     ((packetVersionNumber << PACKET_VERSION_NUMBER_OFFSET)
@@ -212,17 +216,10 @@ boolean ESAT_CCSDSPrimaryHeader::writeTo(Stream& output) const
     ((packetDataLength - PACKET_DATA_LENGTH_INCREMENT)
      << PACKET_DATA_LENGTH_OFFSET)
     & PACKET_DATA_LENGTH_MASK;
-  byte octets[LENGTH];
-  ESAT_Buffer data(octets, sizeof(octets));
-  (void) data.write(highByte(firstWord));
-  (void) data.write(lowByte(firstWord));
-  (void) data.write(highByte(secondWord));
-  (void) data.write(lowByte(secondWord));
-  (void) data.write(highByte(thirdWord));
-  (void) data.write(lowByte(thirdWord));
-  if (data.length() != LENGTH)
-  {
-    return false;
-  }
-  return data.writeTo(output);
+  octets[0] = highByte(firstWord);
+  octets[1] = lowByte(firstWord);
+  octets[2] = highByte(secondWord);
+  octets[3] = lowByte(secondWord);
+  octets[4] = highByte(thirdWord);
+  octets[5] = lowByte(thirdWord);
 }
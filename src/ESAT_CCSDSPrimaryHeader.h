@@ -121,6 +121,26 @@ class ESAT_CCSDSPrimaryHeader: public Printable
     // data length has an invalid value is undefined.
     unsigned long packetDataLength = 0;
 
+    // Return the application process identifier of the primary
+    // header held in the first 6 bytes of a byte array with its
+    // on-wire representation, without decoding the rest of the
+    // primary header.
+    // This is handy for routing packets.
+    static constexpr word peekApplicationProcessIdentifier(const byte octets[])
+    {
+      return ((((word) octets[0]) << 8) | octets[1])
+        & APPLICATION_PROCESS_IDENTIFIER_MASK;
+    }
+
+    // Return the packet type of the primary header held in the first
+    // 6 bytes of a byte array with its on-wire representation,
+    // without decoding the rest of the primary header.
+    // This is handy for routing packets.
+    static constexpr PacketType peekPacketType(const byte octets[])
+    {
+      return PacketType((octets[0] >> (PACKET_TYPE_OFFSET - 8)) & 1);
+    }
+
     // Print the primary header in human readable (JSON) form.
     // Return the number of characters written.
     size_t printTo(Print& output) const;
@@ -129,10 +149,19 @@ class ESAT_CCSDSPrimaryHeader: public Printable
     // Return true on success; otherwise return false.
     boolean readFrom(Stream& input);
 
+    // Read the primary header from the first 6 bytes of a byte array
+    // holding its on-wire representation.
+    // Return true on success; otherwise return false.
+    boolean readFrom(const byte octets[]);
+
     // Write the primary header to an output stream.
     // Return true on success; otherwise return false.
     boolean writeTo(Stream& output) const;
 
+    // Write the on-wire representation of the primary header to the
+    // first 6 bytes of a byte array.
+    void writeTo(byte octets[]) const;
+
   private:
     // Bit masks of the fields of the first 16-bit word
     // of the header.
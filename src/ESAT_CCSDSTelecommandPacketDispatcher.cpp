@@ -32,7 +32,7 @@ void ESAT_CCSDSTelecommandPacketDispatcher::add(ESAT_CCSDSTelecommandPacketHandl
   head = &handler;
 }
 
-boolean ESAT_CCSDSTelecommandPacketDispatcher::compatiblePacket(ESAT_CCSDSPacket packet) const
+boolean ESAT_CCSDSTelecommandPacketDispatcher::compatiblePacket(const ESAT_CCSDSPacket& packet) const
 {
   const ESAT_CCSDSPrimaryHeader primaryHeader
     = packet.readPrimaryHeader();
@@ -55,6 +55,11 @@ boolean ESAT_CCSDSTelecommandPacketDispatcher::compatiblePacket(ESAT_CCSDSPacket
   {
     return false;
   }
+  if (packet.packetErrorControlEnabled()
+      && !packet.correctPacketErrorControl())
+  {
+    return false;
+  }
   return true;
 }
 
@@ -72,14 +77,15 @@ boolean ESAT_CCSDSTelecommandPacketDispatcher::dispatch(ESAT_CCSDSPacket packet)
   {
     if (handlerIsCompatibleWithPacket(*handler, secondaryHeader))
     {
-      return handler->handleUserData(packet);
+      // Hand our copy of the packet over to the handler.
+      return handler->handleUserData(static_cast<ESAT_CCSDSPacket&&>(packet));
     }
   }
   return false;
 }
 
 boolean ESAT_CCSDSTelecommandPacketDispatcher::handlerIsCompatibleWithPacket(ESAT_CCSDSTelecommandPacketHandler& handler,
-                                                                             ESAT_CCSDSSecondaryHeader secondaryHeader)
+                                                                             const ESAT_CCSDSSecondaryHeader& secondaryHeader)
 {
   const ESAT_SemanticVersionNumber handlerVersionNumber =
     handler.versionNumber();
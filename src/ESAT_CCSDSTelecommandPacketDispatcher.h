@@ -51,7 +51,9 @@ class ESAT_CCSDSTelecommandPacketDispatcher
     // - The packet has a secondary header.
     // - The packet's application process identifier is the same
     //   as the telecommand dispatcher's application process identifier.
-    boolean compatiblePacket(ESAT_CCSDSPacket packet) const;
+    // - The packet has a correct packet error control field if
+    //   packet error control is enabled for it.
+    boolean compatiblePacket(const ESAT_CCSDSPacket& packet) const;
 
     // Dispatch a telecommand packet.
     // This will work through the list of packet handlers until one
@@ -67,6 +69,8 @@ class ESAT_CCSDSTelecommandPacketDispatcher
     //   as the telecommand dispatcher's application process identifier.
     // - The packet is compatible with a handler.
     // - The handler handles the packet successfully.
+    // The packet is handed over to the handler without further
+    // copies, so pass a temporary packet to avoid copying it at all.
     // Return true on success; otherwise return false.
     boolean dispatch(ESAT_CCSDSPacket packet);
 
@@ -83,7 +87,7 @@ class ESAT_CCSDSTelecommandPacketDispatcher
     // Return true if the handler is compatible with the packet with
     // given secondary header; otherwise return false.
     boolean handlerIsCompatibleWithPacket(ESAT_CCSDSTelecommandPacketHandler& handler,
-                                          ESAT_CCSDSSecondaryHeader secondaryHeader);
+                                          const ESAT_CCSDSSecondaryHeader& secondaryHeader);
 };
 
 #endif /* ESAT_CCSDSTelecommandPacketDispatcher_h */
@@ -39,6 +39,7 @@ ESAT_CCSDSTelemetryPacketBuilder::ESAT_CCSDSTelemetryPacketBuilder(const word th
   clock = &theClock;
   packetSequenceCount = 0;
   head = nullptr;
+  prepareHeaderTemplates();
 }
 
 void ESAT_CCSDSTelemetryPacketBuilder::add(ESAT_CCSDSTelemetryPacketContents& newPacketContents)
@@ -79,13 +80,7 @@ boolean ESAT_CCSDSTelemetryPacketBuilder::build(ESAT_CCSDSPacket& packet,
   {
     return false;
   }
-  packet.writeTelemetryHeaders(applicationProcessIdentifier,
-                               packetSequenceCount,
-                               clock->read(),
-                               majorVersionNumber,
-                               minorVersionNumber,
-                               patchVersionNumber,
-                               identifier);
+  writeHeaders(packet, identifier, clock->read());
   const boolean userDataCorrect = contents->fillUserData(packet);
   if (packet.triedToWriteBeyondCapacity())
   {
@@ -116,3 +111,42 @@ ESAT_CCSDSTelemetryPacketContents* ESAT_CCSDSTelemetryPacketBuilder::find(const
   // If we didn't find anything, just return nullptr.
   return nullptr;
 }
+
+void ESAT_CCSDSTelemetryPacketBuilder::prepareHeaderTemplates()
+{
+  primaryHeaderTemplate.packetVersionNumber = 0;
+  primaryHeaderTemplate.packetType = primaryHeaderTemplate.TELEMETRY;
+  primaryHeaderTemplate.secondaryHeaderFlag =
+    primaryHeaderTemplate.SECONDARY_HEADER_IS_PRESENT;
+  primaryHeaderTemplate.applicationProcessIdentifier =
+    applicationProcessIdentifier;
+  primaryHeaderTemplate.sequenceFlags =
+    primaryHeaderTemplate.UNSEGMENTED_USER_DATA;
+  // The layout of the raw secondary header is: preamble (1 byte),
+  // timestamp (7 bytes), major, minor and patch version numbers
+  // (1 byte each) and packet identifier (1 byte).
+  secondaryHeaderTemplate[0] =
+    ESAT_CCSDSSecondaryHeader::CALENDAR_SEGMENTED_TIME_CODE_MONTH_DAY_VARIANT_1_SECOND_RESOLUTION;
+  secondaryHeaderTemplateTimestamp.writeTo(&secondaryHeaderTemplate[1]);
+  secondaryHeaderTemplate[8] = majorVersionNumber;
+  secondaryHeaderTemplate[9] = minorVersionNumber;
+  secondaryHeaderTemplate[10] = patchVersionNumber;
+  secondaryHeaderTemplate[11] = 0;
+}
+
+void ESAT_CCSDSTelemetryPacketBuilder::writeHeaders(ESAT_CCSDSPacket& packet,
+                                                    const byte identifier,
+                                                    const ESAT_Timestamp timestamp)
+{
+  primaryHeaderTemplate.packetSequenceCount = packetSequenceCount;
+  if (!(timestamp == secondaryHeaderTemplateTimestamp))
+  {
+    timestamp.writeTo(&secondaryHeaderTemplate[1]);
+    secondaryHeaderTemplateTimestamp = timestamp;
+  }
+  secondaryHeaderTemplate[11] = identifier;
+  packet.rewind();
+  packet.writePrimaryHeader(primaryHeaderTemplate);
+  (void) packet.write(secondaryHeaderTemplate,
+                      sizeof(secondaryHeaderTemplate));
+}
@@ -87,9 +87,33 @@ class ESAT_CCSDSTelemetryPacketBuilder
     // Head of the list of packet contents objects.
     ESAT_CCSDSTelemetryPacketContents* head;
 
+    // Template of the primary header of the packets.
+    // Only the packet sequence count changes from packet to packet.
+    ESAT_CCSDSPrimaryHeader primaryHeaderTemplate;
+
+    // Template of the raw secondary header of the packets.
+    // Only the timestamp and the packet identifier change from packet
+    // to packet, so building a packet just patches them and copies
+    // the whole template into the packet with one bulk write.
+    byte secondaryHeaderTemplate[ESAT_CCSDSSecondaryHeader::LENGTH];
+
+    // Timestamp currently encoded in the secondary header template.
+    // Packets built in the same second reuse the encoded timestamp.
+    ESAT_Timestamp secondaryHeaderTemplateTimestamp;
+
     // Return the packet contents object with the given identifier
     // or nullptr if none can be found.
     ESAT_CCSDSTelemetryPacketContents* find(byte identififer);
+
+    // Fill the header templates with the fields that don't change from
+    // packet to packet.
+    void prepareHeaderTemplates();
+
+    // Write the primary and secondary headers of a new packet with
+    // the given identifier and timestamp from the header templates.
+    void writeHeaders(ESAT_CCSDSPacket& packet,
+                      byte identifier,
+                      ESAT_Timestamp timestamp);
 };
 
 #endif /* ESAT_CCSDSTelemetryPacketBuilder_h */
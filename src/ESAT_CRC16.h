@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_CRC16_h
+#define ESAT_CRC16_h
+
+#include <Arduino.h>
+
+// 16-bit cyclic redundancy check (CRC) calculator for the packet
+// error control field of CCSDS space packets: CRC-16-CCITT with
+// generator polynomial x^16 + x^12 + x^5 + 1, initial remainder
+// 0xFFFF, most significant bit first and no final exclusive or.
+// Write your message to the CRC calculator and then get the CRC
+// remainder with value().
+// The remainder is updated a byte at a time with a lookup table kept
+// in program memory.
+class ESAT_CRC16: public Print
+{
+  public:
+    // Initial remainder of the CRC computation for packet error
+    // control fields.
+    static const word INITIAL_REMAINDER = 0xFFFF;
+
+    // Create a CRC calculator starting with the standard initial
+    // remainder.
+    ESAT_CRC16();
+
+    // Create a CRC calculator starting with the given initial
+    // remainder.
+    ESAT_CRC16(word initialRemainder);
+
+    // Return the remainder that results from processing the given
+    // number of zero bytes starting with the given remainder.
+    // As the CRC is linear, the CRC of a message starting with a
+    // remainder R equals the CRC of the same message starting with 0
+    // exclusive-or the CRC of as many zero bytes starting with R,
+    // so CRCs of pieces of a message can be computed independently
+    // and combined afterwards.
+    // This takes a time proportional to the logarithm of the number
+    // of bytes.
+    static word advance(word remainder, unsigned long bytes);
+
+    // Restart the CRC computation with the initial remainder passed
+    // to the constructor.
+    void flush();
+
+    // Return the current CRC remainder.
+    word value() const;
+
+    // Update the CRC remainder with a new byte datum.
+    // Return 1.
+    size_t write(uint8_t datum);
+
+    // Update the CRC remainder with the given message buffer.
+    // Return the number of bytes written.
+    size_t write(const uint8_t* buffer, size_t bufferLength);
+
+  private:
+    // Initial remainder of the CRC computation.
+    word initialRemainder;
+
+    // Current CRC remainder.
+    word remainder;
+
+    // Return the product of two polynomials modulo the generator
+    // polynomial.
+    static word multiply(word multiplicand, word multiplier);
+};
+
+#endif /* ESAT_CRC16_h */
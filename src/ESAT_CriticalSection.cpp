@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_CriticalSection.h"
+
+#if defined(__arm__) && defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+#define ESAT_CRITICAL_SECTIONS_USE_PRIMASK
+#endif
+
+#if !defined(ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS)
+#include <atomic>
+
+// Global lock of host critical sections.
+static std::atomic_flag criticalSectionLock = ATOMIC_FLAG_INIT;
+#elif defined(__MSP430__)
+#include <msp430.h>
+#elif !defined(__AVR__) && !defined(ESAT_CRITICAL_SECTIONS_USE_PRIMASK) && !defined(ESP8266) && !defined(ESP32)
+// Number of nested critical sections of targets masking interrupts
+// with noInterrupts().
+static volatile byte criticalSectionDepth = 0;
+#endif
+
+ESAT_CriticalSection::ESAT_CriticalSection()
+{
+#if !defined(ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS)
+  while (criticalSectionLock.test_and_set(std::memory_order_acquire))
+  {
+  }
+#elif defined(__AVR__)
+  interruptState = SREG;
+  cli();
+#elif defined(__MSP430__)
+  interruptState = __get_interrupt_state();
+  __disable_interrupt();
+#elif defined(ESAT_CRITICAL_SECTIONS_USE_PRIMASK)
+  unsigned long primask;
+  asm volatile ("mrs %0, primask" : "=r" (primask));
+  asm volatile ("cpsid i" : : : "memory");
+  interruptState = primask;
+#elif defined(ESP8266)
+  interruptState = xt_rsil(15);
+#elif defined(ESP32)
+  interruptState = portSET_INTERRUPT_MASK_FROM_ISR();
+#else
+  noInterrupts();
+  interruptState = criticalSectionDepth;
+  criticalSectionDepth = interruptState + 1;
+#endif
+}
+
+ESAT_CriticalSection::~ESAT_CriticalSection()
+{
+#if !defined(ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS)
+  criticalSectionLock.clear(std::memory_order_release);
+#elif defined(__AVR__)
+  SREG = interruptState;
+#elif defined(__MSP430__)
+  __set_interrupt_state(interruptState);
+#elif defined(ESAT_CRITICAL_SECTIONS_USE_PRIMASK)
+  const unsigned long primask = interruptState;
+  asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+#elif defined(ESP8266)
+  xt_wsr_ps(interruptState);
+#elif defined(ESP32)
+  portCLEAR_INTERRUPT_MASK_FROM_ISR(interruptState);
+#else
+  // Enable interrupts again only when leaving the outermost critical
+  // section.
+  criticalSectionDepth = interruptState;
+  if (interruptState == 0)
+  {
+    interrupts();
+  }
+#endif
+}
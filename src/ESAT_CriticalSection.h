@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_CriticalSection_h
+#define ESAT_CriticalSection_h
+
+#include <Arduino.h>
+
+// Host builds (on Linux, macOS or Windows, or with ESAT_HOST_BUILD
+// defined) run the library with threads instead of interrupts.
+#if defined(__linux__) || defined(__APPLE__) || defined(_WIN32)
+#ifndef ESAT_HOST_BUILD
+#define ESAT_HOST_BUILD
+#endif
+#endif
+
+// On host builds, critical sections take a global spin lock; on
+// microcontrollers, they mask interrupts, as a spin lock held by the
+// main loop would make a contending interrupt handler spin forever.
+#ifndef ESAT_HOST_BUILD
+#define ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+#endif
+
+// Scoped critical section.
+// Declare an ESAT_CriticalSection variable to make the rest of the
+// enclosing block atomic with respect to interrupt handlers (or to
+// other threads on host builds).  The previous interrupt state is
+// restored when the variable goes out of scope, so critical sections
+// can be used both from the main loop and from interrupt handlers.
+// Keep critical sections short, as they delay interrupts, and don't
+// nest them, as the host spin lock isn't reentrant.
+// Interrupts are masked with the native instructions of AVR, MSP430,
+// ARM Cortex-M, ESP8266 and ESP32 targets and with noInterrupts() on
+// other targets.  As the Arduino API can't tell whether interrupts
+// were enabled, critical sections of those other targets enable them
+// again when leaving the outermost critical section, even in
+// interrupt handlers.
+class ESAT_CriticalSection
+{
+  public:
+    // Enter the critical section.
+    ESAT_CriticalSection();
+
+    // Critical sections can't be copied.
+    ESAT_CriticalSection(const ESAT_CriticalSection& original) = delete;
+
+    // Leave the critical section.
+    ~ESAT_CriticalSection();
+
+    // Critical sections can't be copied.
+    ESAT_CriticalSection& operator=(const ESAT_CriticalSection& original) = delete;
+
+#ifdef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+  private:
+    // Interrupt state at the start of the critical section.
+    unsigned long interruptState;
+#endif
+};
+
+#endif /* ESAT_CriticalSection_h */
@@ -161,10 +161,7 @@ boolean ESAT_I2CMasterClass::packetMatchesRequest(ESAT_CCSDSPacket& packet,
       return false;
     }
     packet.rewind();
-    const ESAT_CCSDSSecondaryHeader secondaryHeader
-      = packet.readSecondaryHeader();
-    packet.rewind();
-    if (secondaryHeader.packetIdentifier != requestedPacket)
+    if (packet.peekSecondaryHeader().packetIdentifier != requestedPacket)
     {
       return false;
     }
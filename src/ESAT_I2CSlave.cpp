@@ -19,6 +19,7 @@
  */
 
 #include "ESAT_I2CSlave.h"
+#include "ESAT_MemoryAccounting.h"
 
 const ESAT_SemanticVersionNumber ESAT_I2CSlaveClass::VERSION_NUMBER(1, 0, 0);
 
@@ -34,6 +35,7 @@ void ESAT_I2CSlaveClass::begin(TwoWire& i2cInterface,
                                const unsigned long masterReadPacketDataCapacity,
                                const unsigned long inputPacketBufferCapacity)
 {
+  ESAT_MemoryAccountingScope accountingScope(ESAT_MemoryAccounting.I2C_SLAVE);
   bus = &i2cInterface;
   i2cState = IDLE;
   masterWritePacket = ESAT_CCSDSPacket(masterWritePacketDataCapacity);
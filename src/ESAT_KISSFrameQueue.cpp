@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_KISSFrameQueue.h"
+#include "ESAT_MemoryAccounting.h"
+
+ESAT_KISSFrameQueue::ESAT_KISSFrameQueue()
+{
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  arena = ESAT_Buffer();
+  arenaMemory = nullptr;
+  frames = nullptr;
+  memoryIsDynamic = false;
+  frameRecords = 0;
+  flush();
+}
+
+ESAT_KISSFrameQueue::ESAT_KISSFrameQueue(const unsigned long arenaCapacity,
+                                         const byte maximumFrames)
+{
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  arena = ESAT_Buffer();
+  arenaMemory = nullptr;
+  frames = nullptr;
+  memoryIsDynamic = false;
+  frameRecords = 0;
+  flush();
+  // Just fail if there is no memory for the arena or the records.
+  ESAT_MemoryAccountingScope accountingScope(ESAT_MemoryAccounting.KISS_STREAM);
+  byte* const memory = new byte[arenaCapacity];
+  FrameRecord* const records = new FrameRecord[maximumFrames];
+  if ((memory == nullptr) || (records == nullptr))
+  {
+    delete[] memory;
+    delete[] records;
+    return;
+  }
+  // Normal operation: wrap the arena memory in a buffer that doesn't
+  // copy on write, so views of queued frames handed out by frame()
+  // can't make later writes move the arena to another place.
+  accountedComponent =
+    ESAT_MemoryAccounting.recordAllocation(arenaCapacity
+                                           + maximumFrames
+                                           * sizeof(FrameRecord));
+  arena = ESAT_Buffer(memory, arenaCapacity, arenaCapacity);
+  arenaMemory = memory;
+  frames = records;
+  memoryIsDynamic = true;
+  frameRecords = maximumFrames;
+}
+
+ESAT_KISSFrameQueue::ESAT_KISSFrameQueue(byte array[],
+                                         const unsigned long arrayLength,
+                                         const byte maximumFrames)
+{
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  arena = ESAT_Buffer();
+  arenaMemory = nullptr;
+  frames = nullptr;
+  memoryIsDynamic = false;
+  frameRecords = 0;
+  flush();
+  // Fall through when there is no memory.
+  if (array == nullptr)
+  {
+    return;
+  }
+  // Normal operation: align the start of the array for the frame
+  // records and use the rest of it as memory arena.
+  const unsigned long misalignment = ((uintptr_t) array) % ALIGNMENT;
+  const unsigned long padding =
+    (misalignment == 0) ? 0 : (ALIGNMENT - misalignment);
+  const unsigned long recordsLength = maximumFrames * sizeof(FrameRecord);
+  if (arrayLength < padding + recordsLength)
+  {
+    return;
+  }
+  frames = (FrameRecord*) (array + padding);
+  frameRecords = maximumFrames;
+  const unsigned long arenaCapacity = arrayLength - padding - recordsLength;
+  arena = ESAT_Buffer(array + padding + recordsLength,
+                      arenaCapacity,
+                      arenaCapacity);
+}
+
+ESAT_KISSFrameQueue::ESAT_KISSFrameQueue(ESAT_KISSFrameQueue&& original)
+{
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  arenaMemory = nullptr;
+  frames = nullptr;
+  memoryIsDynamic = false;
+  frameRecords = 0;
+  moveFrom(original);
+}
+
+ESAT_KISSFrameQueue::~ESAT_KISSFrameQueue()
+{
+  clear();
+}
+
+unsigned long ESAT_KISSFrameQueue::availableForRead() const
+{
+  return numberOfFrames;
+}
+
+unsigned long ESAT_KISSFrameQueue::capacity() const
+{
+  return arena.capacity();
+}
+
+void ESAT_KISSFrameQueue::clear()
+{
+  if (memoryIsDynamic)
+  {
+    ESAT_MemoryAccounting.recordDeallocation(accountedComponent,
+                                             arena.capacity()
+                                             + frameRecords
+                                             * sizeof(FrameRecord));
+    delete[] arenaMemory;
+    delete[] frames;
+  }
+  accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  arena = ESAT_Buffer();
+  arenaMemory = nullptr;
+  frames = nullptr;
+  memoryIsDynamic = false;
+  frameRecords = 0;
+  flush();
+}
+
+void ESAT_KISSFrameQueue::drop()
+{
+  // Fall through when the queue is empty.
+  if (numberOfFrames == 0)
+  {
+    return;
+  }
+  // Normal operation: forget the record of the first frame.
+  firstFrame = (firstFrame + 1) % frameRecords;
+  numberOfFrames = numberOfFrames - 1;
+}
+
+void ESAT_KISSFrameQueue::flush()
+{
+  firstFrame = 0;
+  numberOfFrames = 0;
+}
+
+ESAT_BufferView ESAT_KISSFrameQueue::frame() const
+{
+  if (numberOfFrames == 0)
+  {
+    return ESAT_BufferView();
+  }
+  return ESAT_BufferView(arena,
+                         frames[firstFrame].offset,
+                         frames[firstFrame].length);
+}
+
+unsigned long ESAT_KISSFrameQueue::frameLength() const
+{
+  if (numberOfFrames == 0)
+  {
+    return 0;
+  }
+  return frames[firstFrame].length;
+}
+
+boolean ESAT_KISSFrameQueue::hasRoomFor(const unsigned long frameLength) const
+{
+  return writeOffset(frameLength) <= capacity();
+}
+
+byte ESAT_KISSFrameQueue::maximumFrames() const
+{
+  return frameRecords;
+}
+
+void ESAT_KISSFrameQueue::moveFrom(ESAT_KISSFrameQueue& original)
+{
+  accountedComponent = original.accountedComponent;
+  arena = static_cast<ESAT_Buffer&&>(original.arena);
+  arenaMemory = original.arenaMemory;
+  firstFrame = original.firstFrame;
+  frames = original.frames;
+  memoryIsDynamic = original.memoryIsDynamic;
+  frameRecords = original.frameRecords;
+  numberOfFrames = original.numberOfFrames;
+  original.accountedComponent = ESAT_MemoryAccounting.UNACCOUNTED;
+  original.arena = ESAT_Buffer();
+  original.arenaMemory = nullptr;
+  original.firstFrame = 0;
+  original.frames = nullptr;
+  original.memoryIsDynamic = false;
+  original.frameRecords = 0;
+  original.numberOfFrames = 0;
+}
+
+boolean ESAT_KISSFrameQueue::read(Stream& output)
+{
+  // Just fail if the queue is empty.
+  if (numberOfFrames == 0)
+  {
+    return false;
+  }
+  // Normal operation: copy the frame in bulk and drop it even if
+  // the output stream didn't take all of it, so that a stuck output
+  // stream can't block the queue.
+  const ESAT_BufferView frameView = frame();
+  drop();
+  return frameView.writeTo(output);
+}
+
+boolean ESAT_KISSFrameQueue::write(const ESAT_Buffer& frame)
+{
+  const unsigned long length = frame.length();
+  const unsigned long offset = writeOffset(length);
+  // Just fail if there is no room for the frame.
+  if (offset > capacity())
+  {
+    return false;
+  }
+  // Normal operation: copy the frame in bulk to the arena and record
+  // its place.  Writing to the arena truncates its length to the end
+  // of the frame, so restore it to the whole arena afterwards.
+  if (length > 0)
+  {
+    (void) arena.seek(offset);
+    const boolean correctWrite = frame.writeTo(arena);
+    (void) arena.setLength(arena.capacity());
+    if (!correctWrite)
+    {
+      return false;
+    }
+  }
+  const byte record = (firstFrame + numberOfFrames) % frameRecords;
+  frames[record].offset = offset;
+  frames[record].length = length;
+  numberOfFrames = numberOfFrames + 1;
+  return true;
+}
+
+ESAT_KISSFrameQueue& ESAT_KISSFrameQueue::operator=(ESAT_KISSFrameQueue&& original)
+{
+  if (this != &original)
+  {
+    clear();
+    moveFrom(original);
+  }
+  return *this;
+}
+
+unsigned long ESAT_KISSFrameQueue::writeOffset(const unsigned long frameLength) const
+{
+  const unsigned long noRoom = capacity() + 1;
+  // Fail when all the records are taken.
+  if (numberOfFrames >= frameRecords)
+  {
+    return noRoom;
+  }
+  // Start from the beginning of the arena when the queue is empty.
+  if (numberOfFrames == 0)
+  {
+    return (frameLength <= capacity()) ? 0 : noRoom;
+  }
+  // Otherwise, the free space goes from the end of the last frame to
+  // the start of the first frame, wrapping around the end of the
+  // arena.  The frames have wrapped around when any of them starts
+  // before the first one (empty frames make comparing the first and
+  // last frames alone ambiguous).
+  const FrameRecord& first = frames[firstFrame];
+  const FrameRecord& last =
+    frames[(firstFrame + numberOfFrames - 1) % frameRecords];
+  const unsigned long end = last.offset + last.length;
+  boolean wrapped = false;
+  for (byte i = 1; i < numberOfFrames; i++)
+  {
+    if (frames[(firstFrame + i) % frameRecords].offset < first.offset)
+    {
+      wrapped = true;
+    }
+  }
+  if (!wrapped)
+  {
+    if (frameLength <= capacity() - end)
+    {
+      return end;
+    }
+    return (frameLength <= first.offset) ? 0 : noRoom;
+  }
+  return (frameLength <= first.offset - end) ? end : noRoom;
+}
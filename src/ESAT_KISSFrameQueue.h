@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_KISSFrameQueue_h
+#define ESAT_KISSFrameQueue_h
+
+#include <Arduino.h>
+#include "ESAT_Buffer.h"
+#include "ESAT_BufferView.h"
+
+// Bounded queue of decoded KISS frames.
+// Frames are stored one after another in a single memory arena used
+// as a ring, with an offset and length record per frame, so a burst
+// of frames can be received at once with
+// ESAT_KISSStream::receiveFrames() and drained later in a batch.
+// The number of frame records is set at construction, together with
+// the capacity of the arena.
+class ESAT_KISSFrameQueue
+{
+  public:
+    // Instantiate a zero-capacity frame queue.
+    ESAT_KISSFrameQueue();
+
+    // Instantiate a frame queue that can hold up to a maximum number
+    // of frames, with a dynamic memory arena of given capacity.
+    ESAT_KISSFrameQueue(unsigned long arenaCapacity, byte maximumFrames);
+
+    // Instantiate a frame queue that can hold up to a maximum number
+    // of frames, with its frame records and its memory arena in the
+    // given array of given length.
+    // Use memoryLength() to size the array for a given arena
+    // capacity.
+    ESAT_KISSFrameQueue(byte array[],
+                        unsigned long arrayLength,
+                        byte maximumFrames);
+
+    // Frame queues can't be copied.
+    ESAT_KISSFrameQueue(const ESAT_KISSFrameQueue& original) = delete;
+
+    // Move constructor.
+    // Instantiate a frame queue that takes over the frames and the
+    // memory of another frame queue, which is left with zero
+    // capacity.
+    ESAT_KISSFrameQueue(ESAT_KISSFrameQueue&& original);
+
+    // Destroy a frame queue.
+    ~ESAT_KISSFrameQueue();
+
+    // Return the number of frames available for reading.
+    unsigned long availableForRead() const;
+
+    // Return the capacity of the memory arena.
+    unsigned long capacity() const;
+
+    // Remove the next frame from the queue, if any.
+    void drop();
+
+    // Empty the queue.
+    void flush();
+
+    // Return a view of the next frame available for reading
+    // (an empty view if there is none).
+    // The frame stays in the queue; the view is valid until the frame
+    // is removed from the queue, as later writes never move the
+    // memory arena.
+    ESAT_BufferView frame() const;
+
+    // Return the length of the next frame available for reading,
+    // or 0 if there is none.
+    unsigned long frameLength() const;
+
+    // Return true if a frame of given length can be written to the
+    // queue; otherwise return false.
+    boolean hasRoomFor(unsigned long frameLength) const;
+
+    // Return the maximum number of frames the queue can hold.
+    byte maximumFrames() const;
+
+    // Return the length of an array that can hold the frame records
+    // and a memory arena of given capacity of a frame queue with a
+    // given maximum number of frames, including room for alignment.
+    static constexpr unsigned long memoryLength(unsigned long arenaCapacity,
+                                                byte maximumFrames)
+    {
+      return (ALIGNMENT - 1)
+        + maximumFrames * sizeof(FrameRecord)
+        + arenaCapacity;
+    }
+
+    // Write the next frame to an output stream and remove it from the
+    // queue.
+    // Return true on success; otherwise (when the queue is empty or
+    // the output stream didn't take the whole frame) return false.
+    boolean read(Stream& output);
+
+    // Append a copy of the contents of a frame buffer (from the
+    // start to its length()) to the queue.
+    // Return true on success; otherwise (when there is no room for
+    // the frame) return false.
+    boolean write(const ESAT_Buffer& frame);
+
+    // Frame queues can't be copied.
+    ESAT_KISSFrameQueue& operator=(const ESAT_KISSFrameQueue& original) = delete;
+
+    // Move assignment operator: make this queue take over the frames
+    // and the memory of another frame queue, which is left with zero
+    // capacity.
+    ESAT_KISSFrameQueue& operator=(ESAT_KISSFrameQueue&& original);
+
+  private:
+    // Place of a frame in the memory arena.
+    struct FrameRecord
+    {
+      // Offset of the frame from the start of the memory arena.
+      unsigned long offset;
+
+      // Length of the frame.
+      unsigned long length;
+    };
+
+    // Frame records start at multiples of this number of bytes.
+    static const byte ALIGNMENT = alignof(FrameRecord);
+
+    // Memory accounting component charged for the frame records
+    // allocated by the queue itself.
+    byte accountedComponent;
+
+    // Memory arena of the queue.
+    // It always wraps memory that doesn't copy on write, so it stays
+    // in place while views of its frames are alive.
+    ESAT_Buffer arena;
+
+    // Memory of the arena when allocated by the queue itself.
+    byte* arenaMemory;
+
+    // Index of the record of the next frame to be read.
+    byte firstFrame;
+
+    // Number of frame records.
+    byte frameRecords;
+
+    // Records of the frames in the queue, used as a ring.
+    FrameRecord* frames;
+
+    // True when the memory arena and the frame records were allocated
+    // by the queue itself.
+    boolean memoryIsDynamic;
+
+    // Number of frames in the queue.
+    byte numberOfFrames;
+
+    // Free the frame records and the memory arena and leave the queue
+    // with zero capacity.
+    void clear();
+
+    // Make this queue take over the frames and the memory of another
+    // frame queue, which is left with zero capacity.
+    // The queue must be cleared first.
+    void moveFrom(ESAT_KISSFrameQueue& original);
+
+    // Return the offset from the start of the memory arena where a
+    // frame of given length would be written, or capacity() + 1 if
+    // there is no room for it.
+    unsigned long writeOffset(unsigned long frameLength) const;
+};
+
+#endif /* ESAT_KISSFrameQueue_h */
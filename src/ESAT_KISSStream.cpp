@@ -19,12 +19,18 @@
  */
 
 #include "ESAT_KISSStream.h"
+#include "ESAT_MemoryAccounting.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 ESAT_KISSStream::ESAT_KISSStream()
 {
   backendStream = nullptr;
   backendBuffer = ESAT_Buffer();
   decoderState = WAITING_FOR_FRAME_START;
+  lookaheadLength = 0;
+  lookaheadPosition = 0;
   setTimeout(0);
 }
 
@@ -33,15 +39,20 @@ ESAT_KISSStream::ESAT_KISSStream(Stream& stream)
   backendStream = &stream;
   backendBuffer = ESAT_Buffer();
   decoderState = WAITING_FOR_FRAME_START;
+  lookaheadLength = 0;
+  lookaheadPosition = 0;
   setTimeout(0);
 }
 
 ESAT_KISSStream::ESAT_KISSStream(Stream& stream,
                                  const unsigned long bufferCapacity)
 {
+  ESAT_MemoryAccountingScope accountingScope(ESAT_MemoryAccounting.KISS_STREAM);
   backendStream = &stream;
   backendBuffer = ESAT_Buffer(bufferCapacity);
   decoderState = WAITING_FOR_FRAME_START;
+  lookaheadLength = 0;
+  lookaheadPosition = 0;
   setTimeout(0);
 }
 
@@ -52,6 +63,8 @@ ESAT_KISSStream::ESAT_KISSStream(Stream& stream,
   backendStream = &stream;
   backendBuffer = ESAT_Buffer(buffer, bufferLength);
   decoderState = WAITING_FOR_FRAME_START;
+  lookaheadLength = 0;
+  lookaheadPosition = 0;
   setTimeout(0);
 }
 
@@ -70,6 +83,26 @@ size_t ESAT_KISSStream::append(const byte datum)
   }
 }
 
+size_t ESAT_KISSStream::append(const byte data[],
+                               const unsigned long length)
+{
+  // In buffered KISS streams, append the data to the buffer;
+  // in unbuffered KISS streams, write the data directly to
+  // the backend stream.
+  if (length == 0)
+  {
+    return 0;
+  }
+  if (backendBuffer.capacity() > 0)
+  {
+    return backendBuffer.write(data, length);
+  }
+  else
+  {
+    return backendStream->write(data, length);
+  }
+}
+
 int ESAT_KISSStream::available()
 {
   if (decoderState == FINISHED)
@@ -113,6 +146,33 @@ void ESAT_KISSStream::decode(const byte datum)
   }
 }
 
+size_t ESAT_KISSStream::decode(const byte data[], const size_t length)
+{
+  size_t bytesConsumed = 0;
+  while ((bytesConsumed < length) && (decoderState != FINISHED))
+  {
+    // Copy runs of frame data that need no unescaping in bulk.
+    // Bytes that don't fit in the buffer are dropped, as in
+    // decodeFrameData().
+    if (decoderState == DECODING_FRAME_DATA)
+    {
+      const size_t runLength =
+        ordinaryRunLength(&data[bytesConsumed], length - bytesConsumed);
+      (void) append(&data[bytesConsumed], runLength);
+      bytesConsumed = bytesConsumed + runLength;
+      if (bytesConsumed == length)
+      {
+        break;
+      }
+    }
+    // Run special bytes and the bytes of the other states through the
+    // state machine.
+    decode(data[bytesConsumed]);
+    bytesConsumed = bytesConsumed + 1;
+  }
+  return bytesConsumed;
+}
+
 void ESAT_KISSStream::decodeDataFrame(const byte datum)
 {
   switch (datum)
@@ -195,6 +255,26 @@ size_t ESAT_KISSStream::endFrame()
   return frameEndBytesWritten;
 }
 
+unsigned long ESAT_KISSStream::escapedDataLength(const byte data[],
+                                                 const unsigned long dataLength)
+{
+  unsigned long position = 0;
+  unsigned long escapedLength = 0;
+  while (position < dataLength)
+  {
+    const size_t runLength =
+      ordinaryRunLength(&data[position], dataLength - position);
+    escapedLength = escapedLength + runLength;
+    position = position + runLength;
+    if (position < dataLength)
+    {
+      escapedLength = escapedLength + ESCAPE_FACTOR;
+      position = position + 1;
+    }
+  }
+  return escapedLength;
+}
+
 void ESAT_KISSStream::flush()
 {
   if (!backendStream)
@@ -205,6 +285,62 @@ void ESAT_KISSStream::flush()
   reset();
 }
 
+size_t ESAT_KISSStream::ordinaryRunLength(const byte data[],
+                                          const size_t length)
+{
+  size_t position = 0;
+#if defined(__SSE2__)
+  // Compare 16 bytes at a time with both special characters.
+  const __m128i frameEnds = _mm_set1_epi8(char(FRAME_END));
+  const __m128i frameEscapes = _mm_set1_epi8(char(FRAME_ESCAPE));
+  while (length - position >= sizeof(__m128i))
+  {
+    const __m128i chunk =
+      _mm_loadu_si128((const __m128i*) &data[position]);
+    const int specialBytes =
+      _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, frameEnds),
+                                     _mm_cmpeq_epi8(chunk, frameEscapes)));
+    if (specialBytes != 0)
+    {
+      return position + __builtin_ctz(specialBytes);
+    }
+    position = position + sizeof(__m128i);
+  }
+#elif !defined(__AVR__)
+  // Compare a machine word at a time with both special characters:
+  // a word has a byte equal to a character when its exclusive or
+  // with that character repeated has a zero byte.  8-bit
+  // microcontrollers gain nothing from this.
+  const unsigned long ones = ((unsigned long) -1) / 0xFF;
+  const unsigned long highBits = ones << 7;
+  while (length - position >= sizeof(unsigned long))
+  {
+    unsigned long chunk;
+    (void) memcpy(&chunk, &data[position], sizeof(chunk));
+    const unsigned long frameEnds = chunk ^ (ones * FRAME_END);
+    const unsigned long frameEscapes = chunk ^ (ones * FRAME_ESCAPE);
+    const unsigned long specialBytes =
+      ((frameEnds - ones) & ~frameEnds & highBits)
+      | ((frameEscapes - ones) & ~frameEscapes & highBits);
+    if (specialBytes != 0)
+    {
+      break;
+    }
+    position = position + sizeof(chunk);
+  }
+#endif
+  // Find the exact position byte by byte.
+  while (position < length)
+  {
+    if ((data[position] == FRAME_END) || (data[position] == FRAME_ESCAPE))
+    {
+      return position;
+    }
+    position = position + 1;
+  }
+  return length;
+}
+
 int ESAT_KISSStream::peek()
 {
   return backendBuffer.peek();
@@ -233,14 +369,31 @@ boolean ESAT_KISSStream::receiveFrame()
   {
     reset();
   }
-  while ((backendStream->available() > 0)
-         && (decoderState != FINISHED))
+  while (decoderState != FINISHED)
   {
-    const int datum = backendStream->read();
-    if (datum >= 0)
+    if (lookaheadPosition == lookaheadLength)
     {
-      decode(datum);
+      const int availableBytes = backendStream->available();
+      if (availableBytes <= 0)
+      {
+        break;
+      }
+      // Never ask for more bytes than available, so that this
+      // doesn't wait for the backend stream.
+      lookaheadLength =
+        backendStream->readBytes((char*) lookahead,
+                                 min((unsigned long) availableBytes,
+                                     (unsigned long) sizeof(lookahead)));
+      lookaheadPosition = 0;
+      if (lookaheadLength == 0)
+      {
+        break;
+      }
     }
+    lookaheadPosition =
+      lookaheadPosition
+      + decode(&lookahead[lookaheadPosition],
+               lookaheadLength - lookaheadPosition);
   }
   if (decoderState == FINISHED)
   {
@@ -253,6 +406,17 @@ boolean ESAT_KISSStream::receiveFrame()
   }
 }
 
+unsigned long ESAT_KISSStream::receiveFrames(ESAT_KISSFrameQueue& queue)
+{
+  unsigned long framesReceived = 0;
+  while (queue.hasRoomFor(backendBuffer.capacity()) && receiveFrame())
+  {
+    (void) queue.write(backendBuffer);
+    framesReceived = framesReceived + 1;
+  }
+  return framesReceived;
+}
+
 void ESAT_KISSStream::reset()
 {
   backendBuffer.flush();
@@ -275,6 +439,38 @@ size_t ESAT_KISSStream::write(const uint8_t datum)
   }
 }
 
+size_t ESAT_KISSStream::write(const uint8_t buffer[],
+                              const size_t bufferLength)
+{
+  // Just fail on empty KISS streams.
+  if (!backendStream)
+  {
+    return 0;
+  }
+  // Normal operation: write runs of ordinary bytes in bulk and
+  // escape the special bytes between them.
+  size_t bytesConsumed = 0;
+  while (bytesConsumed < bufferLength)
+  {
+    const size_t runLength =
+      ordinaryRunLength(&buffer[bytesConsumed],
+                        bufferLength - bytesConsumed);
+    const size_t runBytesWritten =
+      append(&buffer[bytesConsumed], runLength);
+    bytesConsumed = bytesConsumed + runBytesWritten;
+    if ((runBytesWritten < runLength) || (bytesConsumed == bufferLength))
+    {
+      return bytesConsumed;
+    }
+    if (write(buffer[bytesConsumed]) == 0)
+    {
+      return bytesConsumed;
+    }
+    bytesConsumed = bytesConsumed + 1;
+  }
+  return bytesConsumed;
+}
+
 size_t ESAT_KISSStream::writeEscapedFrameEnd()
 {
   const size_t frameEscapeBytesWritten =
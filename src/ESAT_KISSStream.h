@@ -24,6 +24,7 @@
 #include <Arduino.h>
 #include <Stream.h>
 #include "ESAT_Buffer.h"
+#include "ESAT_KISSFrameQueue.h"
 
 // KISS frame writer and reader.
 // Operate on a backend stream.
@@ -95,6 +96,12 @@ class ESAT_KISSStream: public Stream
     // reading or writing a new frame.
     size_t endFrame();
 
+    // Return the number of bytes the given data takes once escaped,
+    // which is the data length plus one byte per frame end or frame
+    // escape byte.
+    static unsigned long escapedDataLength(const byte data[],
+                                           unsigned long dataLength);
+
     // Write the contents of the buffer to the backend stream
     // and reset buffer and the encoder state.
     void flush();
@@ -119,8 +126,22 @@ class ESAT_KISSStream: public Stream
     // Return true if a full frame has arrived; otherwise return false.
     // If there was a new frame in the last call to receiveFrame(),
     // start the reception of a new frame.
+    // This reads the available bytes of the backend stream in chunks
+    // and decodes runs of bytes that need no unescaping in bulk.
+    // Bytes read past the end of a frame are kept for the next call.
     boolean receiveFrame();
 
+    // Receive every complete frame available from the backend stream
+    // and append them to a frame queue, so that bursts of frames can
+    // be received at once and handled later in a batch.
+    // Stop receiving frames when the queue might have no room for the
+    // next one (a frame as long as the buffer capacity), leaving the
+    // rest of the bytes in the backend stream, so no frame is dropped.
+    // This uses the buffer as scratch space, so the frame read by
+    // read() and available() is the last one received.
+    // Return the number of frames received.
+    unsigned long receiveFrames(ESAT_KISSFrameQueue& queue);
+
     // Encode and write a byte.
     // In buffered KISS streams, this writes the encoded byte
     // to the buffer; in unbuffered KISS streams, this writes
@@ -129,9 +150,13 @@ class ESAT_KISSStream: public Stream
     // which may be greater than 1 due to escaping.
     size_t write(uint8_t datum);
 
-    // Import size_t Print::write(const uint8_t* buffer, size_t bufferLength).
-    // Write a byte buffer of given length.
-    // Return the number of bytes written.
+    // Encode and write a byte buffer of given length.
+    // Runs of bytes that need no escaping are found several bytes at
+    // a time and written in bulk.
+    // Return the number of bytes of the buffer consumed.
+    size_t write(const uint8_t buffer[], size_t bufferLength);
+
+    // Import the rest of the Print::write() overloads.
     using Print::write;
 
   private:
@@ -155,6 +180,9 @@ class ESAT_KISSStream: public Stream
       TRANSPOSED_FRAME_ESCAPE = 0xDD,
     };
 
+    // Maximum number of bytes read at once from the backend stream.
+    static const byte LOOKAHEAD_CAPACITY = 32;
+
     // Backend stream.  Read and write operations are performed on it.
     Stream* backendStream;
 
@@ -164,13 +192,30 @@ class ESAT_KISSStream: public Stream
     // Current state of the decoder state machine.
     DecoderState decoderState;
 
+    // Bytes read from the backend stream by receiveFrame().
+    byte lookahead[LOOKAHEAD_CAPACITY];
+
+    // Number of bytes in the lookahead array.
+    byte lookaheadLength;
+
+    // Position of the next byte of the lookahead array to decode.
+    byte lookaheadPosition;
+
     // Append a byte to the backend buffer.
     // Return the number of bytes written.
     size_t append(byte datum);
 
+    // Append a byte array to the backend buffer.
+    // Return the number of bytes written.
+    size_t append(const byte data[], unsigned long length);
+
     // Decode an input byte.
     void decode(byte datum);
 
+    // Decode input bytes up to the end of the current frame.
+    // Return the number of bytes consumed.
+    size_t decode(const byte data[], size_t length);
+
     // Decode the frame command code.
     void decodeDataFrame(byte datum);
 
@@ -183,6 +228,12 @@ class ESAT_KISSStream: public Stream
     // Decode the frame start mark.
     void decodeFrameStart(byte datum);
 
+    // Return the number of bytes at the beginning of a byte array
+    // that need no escaping (the position of the first frame end or
+    // frame escape byte, or the length of the array if there is
+    // none).
+    static size_t ordinaryRunLength(const byte data[], size_t length);
+
     // Reset the encoder/decoder:
     // - set decoderState to WAITING_FOR_FRAME_START;
     // - set decodedDataLength to 0;
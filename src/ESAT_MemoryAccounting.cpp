@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_MemoryAccounting.h"
+#include "ESAT_CriticalSection.h"
+
+unsigned long ESAT_MemoryAccountingClass::allocations(const Component component) const
+{
+  if (component >= NUMBER_OF_COMPONENTS)
+  {
+    return 0;
+  }
+  ESAT_CriticalSection criticalSection;
+  return allocationCount[component];
+}
+
+void ESAT_MemoryAccountingClass::begin()
+{
+  ESAT_CriticalSection criticalSection;
+  for (byte component = 0;
+       component < NUMBER_OF_COMPONENTS;
+       component = component + 1)
+  {
+    allocationCount[component] = 0;
+    liveByteCount[component] = 0;
+    peakByteCount[component] = 0;
+  }
+  chargedComponent = BUFFER;
+  accounting = true;
+}
+
+ESAT_MemoryAccountingClass::Component ESAT_MemoryAccountingClass::currentComponent() const
+{
+  return chargedComponent;
+}
+
+void ESAT_MemoryAccountingClass::end()
+{
+  accounting = false;
+}
+
+unsigned long ESAT_MemoryAccountingClass::liveBytes(const Component component) const
+{
+  if (component >= NUMBER_OF_COMPONENTS)
+  {
+    return 0;
+  }
+  ESAT_CriticalSection criticalSection;
+  return liveByteCount[component];
+}
+
+unsigned long ESAT_MemoryAccountingClass::peakBytes(const Component component) const
+{
+  if (component >= NUMBER_OF_COMPONENTS)
+  {
+    return 0;
+  }
+  ESAT_CriticalSection criticalSection;
+  return peakByteCount[component];
+}
+
+byte ESAT_MemoryAccountingClass::recordAllocation(const unsigned long bytes)
+{
+  // Fall through when accounting isn't running.
+  if (!accounting)
+  {
+    return UNACCOUNTED;
+  }
+  // Normal operation: charge the allocation to the current component.
+  ESAT_CriticalSection criticalSection;
+  const Component component = chargedComponent;
+  allocationCount[component] = allocationCount[component] + 1;
+  liveByteCount[component] = liveByteCount[component] + bytes;
+  if (liveByteCount[component] > peakByteCount[component])
+  {
+    peakByteCount[component] = liveByteCount[component];
+  }
+  return component;
+}
+
+void ESAT_MemoryAccountingClass::recordDeallocation(const byte component,
+                                                    const unsigned long bytes)
+{
+  // Fall through on allocations that weren't accounted for.
+  if (component >= NUMBER_OF_COMPONENTS)
+  {
+    return;
+  }
+  // Normal operation: credit the deallocation back to the component.
+  ESAT_CriticalSection criticalSection;
+  if (liveByteCount[component] > bytes)
+  {
+    liveByteCount[component] = liveByteCount[component] - bytes;
+  }
+  else
+  {
+    liveByteCount[component] = 0;
+  }
+}
+
+void ESAT_MemoryAccountingClass::resetPeakBytes()
+{
+  ESAT_CriticalSection criticalSection;
+  for (byte component = 0;
+       component < NUMBER_OF_COMPONENTS;
+       component = component + 1)
+  {
+    peakByteCount[component] = liveByteCount[component];
+  }
+}
+
+boolean ESAT_MemoryAccountingClass::running() const
+{
+  return accounting;
+}
+
+ESAT_MemoryAccountingClass::Component ESAT_MemoryAccountingClass::setCurrentComponent(const Component component)
+{
+  const Component previousComponent = chargedComponent;
+  chargedComponent = component;
+  return previousComponent;
+}
+
+unsigned long ESAT_MemoryAccountingClass::totalLiveBytes() const
+{
+  unsigned long bytes = 0;
+  for (byte component = 0;
+       component < NUMBER_OF_COMPONENTS;
+       component = component + 1)
+  {
+    bytes = bytes + liveBytes(Component(component));
+  }
+  return bytes;
+}
+
+ESAT_MemoryAccountingScope::ESAT_MemoryAccountingScope(const ESAT_MemoryAccountingClass::Component component)
+{
+  previousComponent = ESAT_MemoryAccounting.setCurrentComponent(component);
+}
+
+ESAT_MemoryAccountingScope::~ESAT_MemoryAccountingScope()
+{
+  (void) ESAT_MemoryAccounting.setCurrentComponent(previousComponent);
+}
+
+ESAT_MemoryAccountingClass ESAT_MemoryAccounting;
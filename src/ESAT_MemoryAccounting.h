@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_MemoryAccounting_h
+#define ESAT_MemoryAccounting_h
+
+#include <Arduino.h>
+
+// Opt-in accounting of the dynamic memory held by the library.
+// Use the global instance ESAT_MemoryAccounting.
+// Start accounting with ESAT_MemoryAccounting.begin() before setting
+// up the other library objects (allocations made before that aren't
+// accounted for).
+// Allocations are charged to the component that makes them (see
+// ESAT_MemoryAccountingScope); allocations made outside of any
+// component are charged to the BUFFER component.
+// Query the live bytes, peak bytes and allocation count of each
+// component at run time, or send them in a housekeeping telemetry
+// packet with ESAT_MemoryAccountingTelemetry.
+class ESAT_MemoryAccountingClass
+{
+  public:
+    // Library components that allocate dynamic memory.
+    enum Component
+    {
+      BUFFER = 0,
+      PACKET_QUEUE = 1,
+      KISS_STREAM = 2,
+      I2C_SLAVE = 3,
+      SUBSYSTEM_PACKET_HANDLER = 4,
+    };
+
+    // Number of components.
+    static const byte NUMBER_OF_COMPONENTS = 5;
+
+    // Component of allocations that aren't accounted for.
+    static const byte UNACCOUNTED = 0xFF;
+
+    // Return the number of allocations charged to a component.
+    unsigned long allocations(Component component) const;
+
+    // Start accounting and reset all statistics.
+    void begin();
+
+    // Return the component that is charged for new allocations.
+    Component currentComponent() const;
+
+    // Stop accounting.
+    // Allocations made while accounting was running are still
+    // credited back when they are freed.
+    void end();
+
+    // Return the number of bytes currently allocated by a component.
+    unsigned long liveBytes(Component component) const;
+
+    // Return the highest number of bytes allocated at the same time
+    // by a component since begin() or since the last call to
+    // resetPeakBytes().
+    unsigned long peakBytes(Component component) const;
+
+    // Charge an allocation of a number of bytes to the current
+    // component.
+    // Return the component charged for the allocation (or UNACCOUNTED
+    // when accounting isn't running); pass it to recordDeallocation()
+    // when freeing the memory.
+    byte recordAllocation(unsigned long bytes);
+
+    // Credit a deallocation of a number of bytes back to a component
+    // (as returned by recordAllocation()).
+    void recordDeallocation(byte component, unsigned long bytes);
+
+    // Set the peak bytes of every component to its live bytes.
+    void resetPeakBytes();
+
+    // Return true while accounting is running; otherwise return false.
+    boolean running() const;
+
+    // Set the component that is charged for new allocations.
+    // Return the previous component.
+    // ESAT_MemoryAccountingScope is more convenient.
+    Component setCurrentComponent(Component component);
+
+    // Return the number of bytes currently allocated by all the
+    // components.
+    unsigned long totalLiveBytes() const;
+
+  private:
+    // Allocation count of each component.
+    unsigned long allocationCount[NUMBER_OF_COMPONENTS];
+
+    // Component charged for new allocations.
+    Component chargedComponent;
+
+    // Live bytes of each component.
+    unsigned long liveByteCount[NUMBER_OF_COMPONENTS];
+
+    // Peak bytes of each component.
+    unsigned long peakByteCount[NUMBER_OF_COMPONENTS];
+
+    // True while accounting is running.
+    boolean accounting;
+};
+
+// Global instance of the memory accounting library.
+extern ESAT_MemoryAccountingClass ESAT_MemoryAccounting;
+
+// Scoped component charge.
+// Declare an ESAT_MemoryAccountingScope variable to charge the
+// allocations made in the rest of the enclosing block to a given
+// component.  The previous component is charged again when the
+// variable goes out of scope.
+class ESAT_MemoryAccountingScope
+{
+  public:
+    // Start charging allocations to the given component.
+    ESAT_MemoryAccountingScope(ESAT_MemoryAccountingClass::Component component);
+
+    // Scopes can't be copied.
+    ESAT_MemoryAccountingScope(const ESAT_MemoryAccountingScope& original) = delete;
+
+    // Charge allocations to the previous component again.
+    ~ESAT_MemoryAccountingScope();
+
+    // Scopes can't be copied.
+    ESAT_MemoryAccountingScope& operator=(const ESAT_MemoryAccountingScope& original) = delete;
+
+  private:
+    // Component charged before entering the scope.
+    ESAT_MemoryAccountingClass::Component previousComponent;
+};
+
+#endif /* ESAT_MemoryAccounting_h */
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_MemoryAccountingTelemetry.h"
+
+ESAT_MemoryAccountingTelemetry::ESAT_MemoryAccountingTelemetry(const byte packetIdentifier)
+{
+  identifier = packetIdentifier;
+}
+
+boolean ESAT_MemoryAccountingTelemetry::available()
+{
+  return ESAT_MemoryAccounting.running();
+}
+
+boolean ESAT_MemoryAccountingTelemetry::fillUserData(ESAT_CCSDSPacket& packet)
+{
+  for (byte component = 0;
+       component < ESAT_MemoryAccounting.NUMBER_OF_COMPONENTS;
+       component = component + 1)
+  {
+    const ESAT_MemoryAccountingClass::Component accountedComponent =
+      ESAT_MemoryAccountingClass::Component(component);
+    packet.writeUnsignedLong(ESAT_MemoryAccounting.liveBytes(accountedComponent));
+    packet.writeUnsignedLong(ESAT_MemoryAccounting.peakBytes(accountedComponent));
+    packet.writeUnsignedLong(ESAT_MemoryAccounting.allocations(accountedComponent));
+  }
+  return !packet.triedToWriteBeyondCapacity();
+}
+
+byte ESAT_MemoryAccountingTelemetry::packetIdentifier()
+{
+  return identifier;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_MemoryAccountingTelemetry_h
+#define ESAT_MemoryAccountingTelemetry_h
+
+#include <Arduino.h>
+#include "ESAT_CCSDSTelemetryPacketContents.h"
+#include "ESAT_MemoryAccounting.h"
+
+// Housekeeping telemetry packet with the memory accounting
+// statistics of ESAT_MemoryAccounting.
+// Add it to an ESAT_CCSDSTelemetryPacketBuilder or to
+// ESAT_SubsystemPacketHandler with the desired packet identifier.
+// The user data field has, for each component in the order of
+// ESAT_MemoryAccountingClass::Component:
+// - the live bytes (unsigned long);
+// - the peak bytes (unsigned long);
+// - the allocation count (unsigned long).
+// The packet is always available while memory accounting is running.
+class ESAT_MemoryAccountingTelemetry: public ESAT_CCSDSTelemetryPacketContents
+{
+  public:
+    // Instantiate a memory accounting telemetry packet with the given
+    // packet identifier.
+    ESAT_MemoryAccountingTelemetry(byte packetIdentifier);
+
+    // Return true while memory accounting is running; otherwise
+    // return false.
+    boolean available();
+
+    // Fill the user data field of the given packet with the memory
+    // accounting statistics.
+    // Return true on success; otherwise return false.
+    boolean fillUserData(ESAT_CCSDSPacket& packet);
+
+    // Return the packet identifier.
+    byte packetIdentifier();
+
+  private:
+    // Packet identifier of the telemetry packet.
+    byte identifier;
+};
+
+#endif /* ESAT_MemoryAccountingTelemetry_h */
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_ReferenceCount.h"
+
+ESAT_ReferenceCount::ESAT_ReferenceCount(const unsigned long references)
+{
+  reset(references);
+}
+
+unsigned long ESAT_ReferenceCount::decrement()
+{
+#ifdef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+  ESAT_CriticalSection criticalSection;
+  count = count - 1;
+  return count;
+#else
+  return count.fetch_sub(1, std::memory_order_acq_rel) - 1;
+#endif
+}
+
+void ESAT_ReferenceCount::increment()
+{
+#ifdef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+  ESAT_CriticalSection criticalSection;
+  count = count + 1;
+#else
+  (void) count.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+void ESAT_ReferenceCount::reset(const unsigned long references)
+{
+#ifdef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+  ESAT_CriticalSection criticalSection;
+  count = references;
+#else
+  count.store(references, std::memory_order_release);
+#endif
+}
+
+unsigned long ESAT_ReferenceCount::value() const
+{
+#ifdef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+  ESAT_CriticalSection criticalSection;
+  return count;
+#else
+  return count.load(std::memory_order_acquire);
+#endif
+}
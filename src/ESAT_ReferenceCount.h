@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_ReferenceCount_h
+#define ESAT_ReferenceCount_h
+
+#include <Arduino.h>
+#include "ESAT_CriticalSection.h"
+
+#ifndef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+#include <atomic>
+#endif
+
+// Reference count of shared memory (like the backend memory of
+// ESAT_Buffer objects) that is safe to update from interrupt handlers
+// and from the main loop at the same time.
+// Each operation is atomic on its own: on microcontrollers, it masks
+// interrupts just for the duration of the update; elsewhere (host
+// builds), it uses std::atomic.
+class ESAT_ReferenceCount
+{
+  public:
+    // Instantiate an uninitialized reference count.
+    // Use reset() before using it.
+    ESAT_ReferenceCount() = default;
+
+    // Instantiate a reference count with a given number of references.
+    ESAT_ReferenceCount(unsigned long references);
+
+    // Reference counts can't be copied.
+    ESAT_ReferenceCount(const ESAT_ReferenceCount& original) = delete;
+
+    // Remove a reference.
+    // Return the number of remaining references.
+    unsigned long decrement();
+
+    // Add a reference.
+    void increment();
+
+    // Set the number of references.
+    void reset(unsigned long references);
+
+    // Return the current number of references.
+    unsigned long value() const;
+
+    // Reference counts can't be copied.
+    ESAT_ReferenceCount& operator=(const ESAT_ReferenceCount& original) = delete;
+
+  private:
+    // Number of references.
+#ifdef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+    volatile unsigned long count;
+#else
+    std::atomic<unsigned long> count;
+#endif
+};
+
+#endif /* ESAT_ReferenceCount_h */
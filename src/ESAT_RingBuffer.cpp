@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ESAT_RingBuffer.h"
+
+ESAT_RingBuffer::ESAT_RingBuffer()
+{
+  buffer = nullptr;
+  bufferLength = 0;
+  dynamicallyAllocated = false;
+  store(droppedByteCount, 0);
+  store(readIndex, 0);
+  store(writeIndex, 0);
+  // Set the timeout for waiting for stream data to zero, as it
+  // doesn't make sense to wait when reading from these buffers.
+  setTimeout(0);
+}
+
+ESAT_RingBuffer::ESAT_RingBuffer(const unsigned long capacity)
+{
+  buffer = new byte[capacity + 1];
+  if (buffer == nullptr)
+  {
+    bufferLength = 0;
+  }
+  else
+  {
+    bufferLength = capacity + 1;
+  }
+  dynamicallyAllocated = true;
+  store(droppedByteCount, 0);
+  store(readIndex, 0);
+  store(writeIndex, 0);
+  // Set the timeout for waiting for stream data to zero, as it
+  // doesn't make sense to wait when reading from these buffers.
+  setTimeout(0);
+}
+
+ESAT_RingBuffer::ESAT_RingBuffer(byte array[],
+                                 const unsigned long arrayLength)
+{
+  buffer = array;
+  bufferLength = arrayLength;
+  dynamicallyAllocated = false;
+  store(droppedByteCount, 0);
+  store(readIndex, 0);
+  store(writeIndex, 0);
+  // Set the timeout for waiting for stream data to zero, as it
+  // doesn't make sense to wait when reading from these buffers.
+  setTimeout(0);
+}
+
+ESAT_RingBuffer::~ESAT_RingBuffer()
+{
+  if (dynamicallyAllocated)
+  {
+    delete[] buffer;
+  }
+}
+
+unsigned long ESAT_RingBuffer::advance(const unsigned long index,
+                                       const unsigned long bytes) const
+{
+  const unsigned long newIndex = index + bytes;
+  if (newIndex >= bufferLength)
+  {
+    return newIndex - bufferLength;
+  }
+  else
+  {
+    return newIndex;
+  }
+}
+
+int ESAT_RingBuffer::available()
+{
+  // Truncate the result of availableBytes() to fit a 16-bit signed
+  // integer.
+  return min(availableBytes(), (unsigned long) 0x7FFF);
+}
+
+unsigned long ESAT_RingBuffer::availableBytes() const
+{
+  const unsigned long read = load(readIndex);
+  const unsigned long write = load(writeIndex);
+  if (write >= read)
+  {
+    return write - read;
+  }
+  else
+  {
+    return (bufferLength - read) + write;
+  }
+}
+
+unsigned long ESAT_RingBuffer::availableBytesForWrite() const
+{
+  return capacity() - availableBytes();
+}
+
+int ESAT_RingBuffer::availableForWrite()
+{
+  // Truncate the result of availableBytesForWrite() to fit a 16-bit
+  // signed integer.
+  return min(availableBytesForWrite(), (unsigned long) 0x7FFF);
+}
+
+unsigned long ESAT_RingBuffer::capacity() const
+{
+  if (bufferLength > 0)
+  {
+    return bufferLength - 1;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void ESAT_RingBuffer::commit(const unsigned long bytes)
+{
+  const unsigned long bytesToCommit = min(bytes, writeSpanLength());
+  if (bytesToCommit > 0)
+  {
+    store(writeIndex, advance(load(writeIndex), bytesToCommit));
+  }
+}
+
+void ESAT_RingBuffer::consume(const unsigned long bytes)
+{
+  const unsigned long bytesToConsume = min(bytes, availableBytes());
+  if (bytesToConsume > 0)
+  {
+    store(readIndex, advance(load(readIndex), bytesToConsume));
+  }
+}
+
+unsigned long ESAT_RingBuffer::droppedBytes() const
+{
+  return load(droppedByteCount);
+}
+
+void ESAT_RingBuffer::flush()
+{
+  store(readIndex, load(writeIndex));
+}
+
+unsigned long ESAT_RingBuffer::load(const SharedValue& value)
+{
+#ifdef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+  unsigned long currentValue;
+  {
+    ESAT_CriticalSection criticalSection;
+    currentValue = value;
+  }
+  // Don't let the compiler move subsequent accesses to the backend
+  // buffer before the load.
+  asm volatile ("" : : : "memory");
+  return currentValue;
+#else
+  return value.load(std::memory_order_acquire);
+#endif
+}
+
+int ESAT_RingBuffer::peek()
+{
+  if (availableBytes() == 0)
+  {
+    return -1;
+  }
+  return buffer[load(readIndex)];
+}
+
+int ESAT_RingBuffer::read()
+{
+  const int datum = peek();
+  // Advance the read index only when there is a byte available.
+  if (datum > -1)
+  {
+    store(readIndex, advance(load(readIndex), 1));
+  }
+  return datum;
+}
+
+size_t ESAT_RingBuffer::readBytes(char readBuffer[], const size_t length)
+{
+  return readBytes((uint8_t*) readBuffer, length);
+}
+
+size_t ESAT_RingBuffer::readBytes(uint8_t readBuffer[], const size_t length)
+{
+  // Read up to the end of the backend buffer first and then wrap
+  // around to its start.
+  const unsigned long bytesToRead =
+    min((unsigned long) length, availableBytes());
+  const unsigned long bytesBeforeWrapping =
+    min(bytesToRead, readSpanLength());
+  const unsigned long read = load(readIndex);
+  if (bytesBeforeWrapping > 0)
+  {
+    (void) memcpy(readBuffer, buffer + read, bytesBeforeWrapping);
+  }
+  if (bytesToRead > bytesBeforeWrapping)
+  {
+    (void) memcpy(readBuffer + bytesBeforeWrapping,
+                  buffer,
+                  bytesToRead - bytesBeforeWrapping);
+  }
+  if (bytesToRead > 0)
+  {
+    store(readIndex, advance(read, bytesToRead));
+  }
+  return bytesToRead;
+}
+
+const byte* ESAT_RingBuffer::readSpan() const
+{
+  if (buffer == nullptr)
+  {
+    return nullptr;
+  }
+  return buffer + load(readIndex);
+}
+
+unsigned long ESAT_RingBuffer::readSpanLength() const
+{
+  const unsigned long read = load(readIndex);
+  const unsigned long write = load(writeIndex);
+  if (write >= read)
+  {
+    return write - read;
+  }
+  else
+  {
+    return bufferLength - read;
+  }
+}
+
+void ESAT_RingBuffer::store(SharedValue& value, const unsigned long newValue)
+{
+#ifdef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+  // Don't let the compiler move preceding accesses to the backend
+  // buffer after the store.
+  asm volatile ("" : : : "memory");
+  ESAT_CriticalSection criticalSection;
+  value = newValue;
+#else
+  value.store(newValue, std::memory_order_release);
+#endif
+}
+
+size_t ESAT_RingBuffer::write(const uint8_t datum)
+{
+  // Drop the byte when the ring buffer is full.
+  if (availableBytesForWrite() == 0)
+  {
+    store(droppedByteCount, load(droppedByteCount) + 1);
+    return 0;
+  }
+  // Normal operation: write the byte and make it available for
+  // reading.
+  const unsigned long write = load(writeIndex);
+  buffer[write] = datum;
+  store(writeIndex, advance(write, 1));
+  return 1;
+}
+
+size_t ESAT_RingBuffer::write(const uint8_t* const writeBuffer,
+                              const size_t length)
+{
+  // Fall through when there is nothing to write.
+  if (length == 0)
+  {
+    return 0;
+  }
+  // Write up to the end of the backend buffer first and then wrap
+  // around to its start, dropping the bytes that don't fit.
+  const unsigned long bytesToWrite =
+    min((unsigned long) length, availableBytesForWrite());
+  if (bytesToWrite < length)
+  {
+    store(droppedByteCount,
+          load(droppedByteCount) + (length - bytesToWrite));
+  }
+  if (bytesToWrite == 0)
+  {
+    return 0;
+  }
+  const unsigned long write = load(writeIndex);
+  const unsigned long bytesBeforeWrapping =
+    min(bytesToWrite, bufferLength - write);
+  (void) memcpy(buffer + write, writeBuffer, bytesBeforeWrapping);
+  if (bytesToWrite > bytesBeforeWrapping)
+  {
+    (void) memcpy(buffer,
+                  writeBuffer + bytesBeforeWrapping,
+                  bytesToWrite - bytesBeforeWrapping);
+  }
+  store(writeIndex, advance(write, bytesToWrite));
+  return bytesToWrite;
+}
+
+byte* ESAT_RingBuffer::writeSpan()
+{
+  if (buffer == nullptr)
+  {
+    return nullptr;
+  }
+  return buffer + load(writeIndex);
+}
+
+unsigned long ESAT_RingBuffer::writeSpanLength() const
+{
+  // Fall through when there is no backend buffer.
+  if (bufferLength == 0)
+  {
+    return 0;
+  }
+  // Normal operation: the span ends at the end of the backend buffer
+  // or just before the next byte to be read, whatever comes first,
+  // always keeping one byte free.
+  const unsigned long read = load(readIndex);
+  const unsigned long write = load(writeIndex);
+  if (write >= read)
+  {
+    if (read == 0)
+    {
+      return (bufferLength - 1) - write;
+    }
+    else
+    {
+      return bufferLength - write;
+    }
+  }
+  else
+  {
+    return (read - 1) - write;
+  }
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_RingBuffer_h
+#define ESAT_RingBuffer_h
+
+#include <Arduino.h>
+#include <Stream.h>
+#include "ESAT_CriticalSection.h"
+
+#ifndef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+#include <atomic>
+#endif
+
+// Stream interface to a wrap-around byte buffer for continuous byte
+// streams.
+// Unlike ESAT_Buffer, a ring buffer never needs to be flushed to
+// make room for new bytes: reading bytes frees their space for
+// subsequent writes.
+// Ring buffers are lock-free single-producer, single-consumer
+// queues: one context (for example, a serial interrupt handler) may
+// write to the ring buffer while another context (for example, the
+// main loop) reads from it, without any further synchronization.
+// The producer uses only the write methods (availableForWrite(),
+// write(), writeSpan() and commit()) and the consumer uses only the
+// read methods (available(), peek(), read(), readBytes(), readSpan()
+// and consume()).
+// Writes never block: bytes that don't fit are dropped and counted.
+// The contiguous span accessors give direct access to the backend
+// memory for bulk producers and consumers.
+class ESAT_RingBuffer: public Stream
+{
+  public:
+    // Instantiate an empty ring buffer.
+    // An empty ring buffer will fail on reads and writes.
+    ESAT_RingBuffer();
+
+    // Instantiate a ring buffer that can hold a given number of bytes.
+    // The ring buffer will allocate its own memory.
+    ESAT_RingBuffer(unsigned long capacity);
+
+    // Instantiate a ring buffer backed by a byte array of given length.
+    // The ring buffer can hold up to arrayLength - 1 bytes.
+    ESAT_RingBuffer(byte array[], unsigned long arrayLength);
+
+    // Ring buffers can't be copied.
+    ESAT_RingBuffer(const ESAT_RingBuffer& original) = delete;
+
+    // Destroy a ring buffer.
+    ~ESAT_RingBuffer();
+
+    // Consumer side.
+    // Return the number of unread bytes, truncated to an int.
+    int available();
+
+    // Consumer side.
+    // Return the number of unread bytes.
+    unsigned long availableBytes() const;
+
+    // Producer side.
+    // Return the number of bytes that can be written.
+    unsigned long availableBytesForWrite() const;
+
+    // Producer side.
+    // Return the number of bytes that can be written, truncated to
+    // an int.
+    int availableForWrite();
+
+    // Return the number of bytes the ring buffer can hold.
+    unsigned long capacity() const;
+
+    // Producer side.
+    // Make the first bytes of the write span available for reading
+    // after filling them.  The number of bytes is bounded by
+    // writeSpanLength().
+    void commit(unsigned long bytes);
+
+    // Consumer side.
+    // Discard a number of unread bytes, bounded by availableBytes().
+    // Use it after processing the bytes of the read span.
+    void consume(unsigned long bytes);
+
+    // Return the number of bytes that were dropped because the ring
+    // buffer was full.
+    unsigned long droppedBytes() const;
+
+    // Consumer side.
+    // Discard all unread bytes.
+    void flush();
+
+    // Consumer side.
+    // Return the next byte (or -1 if no byte could be read)
+    // without advancing to the next one.
+    int peek();
+
+    // Consumer side.
+    // Return the next byte (or -1 if no byte could be read).
+    int read();
+
+    // Consumer side.
+    // Read up to bufferLength bytes (bounded by the number of unread
+    // bytes) into a byte buffer in at most two bulk copies.
+    // Return the number of bytes read.
+    size_t readBytes(char buffer[], size_t bufferLength);
+
+    // Consumer side.
+    // Read up to bufferLength bytes (bounded by the number of unread
+    // bytes) into a byte buffer in at most two bulk copies.
+    // Return the number of bytes read.
+    size_t readBytes(uint8_t buffer[], size_t bufferLength);
+
+    // Consumer side.
+    // Return a pointer to the longest contiguous run of unread bytes.
+    // Its length is readSpanLength().  Use consume() after
+    // processing them.
+    const byte* readSpan() const;
+
+    // Consumer side.
+    // Return the length of the contiguous run of unread bytes
+    // starting at readSpan().
+    unsigned long readSpanLength() const;
+
+    // Producer side.
+    // Write a byte if there is room for it; otherwise drop it.
+    // Return the actual number of bytes written.
+    size_t write(uint8_t datum);
+
+    // Producer side.
+    // Write the contents of a byte buffer of given length in at most
+    // two bulk copies, dropping the bytes that don't fit.
+    // Return the actual number of bytes written.
+    size_t write(const uint8_t* buffer, size_t bufferLength);
+
+    // Import the rest of the Print::write() overloads.
+    using Print::write;
+
+    // Producer side.
+    // Return a pointer to the longest contiguous run of free bytes.
+    // Its length is writeSpanLength().  Use commit() after filling
+    // them.
+    byte* writeSpan();
+
+    // Producer side.
+    // Return the length of the contiguous run of free bytes starting
+    // at writeSpan().
+    unsigned long writeSpanLength() const;
+
+    // Ring buffers can't be copied.
+    ESAT_RingBuffer& operator=(const ESAT_RingBuffer& original) = delete;
+
+  private:
+    // Values shared between the producer and the consumer.
+#ifdef ESAT_CRITICAL_SECTIONS_MASK_INTERRUPTS
+    typedef volatile unsigned long SharedValue;
+#else
+    typedef std::atomic<unsigned long> SharedValue;
+#endif
+
+    // Backend buffer.
+    byte* buffer;
+
+    // Length of the backend buffer.  One byte is always kept free to
+    // tell a full ring buffer from an empty one.
+    unsigned long bufferLength;
+
+    // Number of dropped bytes.
+    // Written only by the producer.
+    SharedValue droppedByteCount;
+
+    // True when the backend buffer was allocated dynamically.
+    boolean dynamicallyAllocated;
+
+    // Index of the next byte to be read.
+    // Written only by the consumer.
+    SharedValue readIndex;
+
+    // Index of the next byte to be written.
+    // Written only by the producer.
+    SharedValue writeIndex;
+
+    // Advance an index by a number of bytes, wrapping around the end
+    // of the backend buffer.
+    unsigned long advance(unsigned long index, unsigned long bytes) const;
+
+    // Return the value of a shared value.
+    // Loads are atomic and happen after preceding writes to the
+    // backend buffer made by the other side.
+    static unsigned long load(const SharedValue& value);
+
+    // Set the value of a shared value.
+    // Stores are atomic and happen after the preceding writes to the
+    // backend buffer.
+    static void store(SharedValue& value, unsigned long newValue);
+};
+
+#endif /* ESAT_RingBuffer_h */
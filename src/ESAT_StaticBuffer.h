@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_StaticBuffer_h
+#define ESAT_StaticBuffer_h
+
+#include <Arduino.h>
+#include "ESAT_Buffer.h"
+
+// ESAT_Buffer with inline backend memory of compile-time capacity.
+// The backend array is part of the object, so it needs neither heap
+// memory nor a reference count: a static buffer declared as a global
+// variable or as a class member takes a fixed amount of RAM that is
+// known at link time and never fragments the heap.
+// Unlike plain ESAT_Buffer objects, copies of a static buffer have
+// their own backend memory with a copy of the contents.
+// Static buffers can be passed to any function taking an ESAT_Buffer
+// reference, but don't assign to them through such a reference, as
+// this would make them share the backend memory of another buffer.
+template <unsigned long CAPACITY>
+class ESAT_StaticBuffer: public ESAT_Buffer
+{
+  public:
+    static_assert(CAPACITY > 0, "The capacity must be at least 1.");
+
+    // Instantiate an empty static buffer.
+    ESAT_StaticBuffer():
+      ESAT_Buffer(storage, CAPACITY)
+    {
+    }
+
+    // Copy constructor.
+    // Instantiate a static buffer with a copy of the contents and the
+    // read/write position of another static buffer.
+    ESAT_StaticBuffer(const ESAT_StaticBuffer& original):
+      ESAT_Buffer(storage, CAPACITY)
+    {
+      copyFrom(original);
+    }
+
+    // Assignment operator: make this static buffer have a copy of the
+    // contents and the read/write position of another static buffer.
+    ESAT_StaticBuffer& operator=(const ESAT_StaticBuffer& original)
+    {
+      if (this != &original)
+      {
+        copyFrom(original);
+      }
+      return *this;
+    }
+
+  private:
+    // Inline backend memory.
+    byte storage[CAPACITY];
+
+    // Copy the contents and the read/write position of another
+    // static buffer.
+    void copyFrom(const ESAT_StaticBuffer& original)
+    {
+      (void) memcpy(storage, original.storage, original.length());
+      (void) setLength(original.length());
+      (void) seek(original.position());
+    }
+};
+
+#endif /* ESAT_StaticBuffer_h */
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2021 Theia Space, Universidad Politécnica de Madrid
+ *
+ * This file is part of Theia Space's ESAT Util library.
+ *
+ * Theia Space's ESAT Util library is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Theia Space's ESAT Util library is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Theia Space's ESAT Util library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESAT_StaticCCSDSPacket_h
+#define ESAT_StaticCCSDSPacket_h
+
+#include <Arduino.h>
+#include "ESAT_CCSDSPacket.h"
+
+// ESAT_CCSDSPacket with an inline packet data field of compile-time
+// capacity.
+// The packet data array is part of the object, so it needs neither
+// heap memory nor a reference count: a static packet declared as a
+// global variable or as a class member takes a fixed amount of RAM
+// that is known at link time and never fragments the heap.
+// Unlike plain ESAT_CCSDSPacket objects, copies of a static packet
+// have their own packet data field with a copy of the contents.
+// Static packets can be passed to any function taking an
+// ESAT_CCSDSPacket reference, but don't assign to them through such a
+// reference, as this would make them share the packet data field of
+// another packet.
+template <unsigned long PACKET_DATA_CAPACITY>
+class ESAT_StaticCCSDSPacket: public ESAT_CCSDSPacket
+{
+  public:
+    static_assert(PACKET_DATA_CAPACITY > 0,
+                  "The packet data capacity must be at least 1.");
+
+    // Instantiate an empty static packet.
+    // The primary header starts with all fields set to 0.
+    // The read/write pointer starts at 0.
+    ESAT_StaticCCSDSPacket():
+      ESAT_CCSDSPacket(storage, PACKET_DATA_CAPACITY)
+    {
+    }
+
+    // Copy constructor.
+    // Instantiate a static packet with a copy of the primary header,
+    // the packet data and the read/write position of another static
+    // packet.
+    ESAT_StaticCCSDSPacket(const ESAT_StaticCCSDSPacket& original):
+      ESAT_CCSDSPacket(storage, PACKET_DATA_CAPACITY)
+    {
+      copyFrom(original);
+    }
+
+    // Assignment operator: make this static packet have a copy of the
+    // primary header, the packet data and the read/write position of
+    // another static packet.
+    ESAT_StaticCCSDSPacket& operator=(const ESAT_StaticCCSDSPacket& original)
+    {
+      if (this != &original)
+      {
+        copyFrom(original);
+      }
+      return *this;
+    }
+
+  private:
+    // Inline packet data field.
+    byte storage[PACKET_DATA_CAPACITY];
+
+    // Copy the primary header, the packet data and the read/write
+    // position of another static packet.
+    void copyFrom(const ESAT_StaticCCSDSPacket& original)
+    {
+      (void) original.copyTo(*this);
+      (void) seek(original.position());
+    }
+};
+
+#endif /* ESAT_StaticCCSDSPacket_h */
@@ -19,6 +19,7 @@
  */
 
 #include "ESAT_SubsystemPacketHandler.h"
+#include "ESAT_MemoryAccounting.h"
 
 void ESAT_SubsystemPacketHandlerClass::addTelecommand(ESAT_CCSDSTelecommandPacketHandler& telecommand)
 {
@@ -38,8 +39,10 @@ void ESAT_SubsystemPacketHandlerClass::begin(const word applicationProcessIdenti
                                              ESAT_Clock& clock,
                                              TwoWire& i2cInterface,
                                              const unsigned long packetDataCapacity,
-                                             const unsigned long i2cInputPacketBufferCapacity)
+                                             const unsigned long i2cInputPacketBufferCapacity,
+                                             const byte usbInputFrames)
 {
+  ESAT_MemoryAccountingScope accountingScope(ESAT_MemoryAccounting.SUBSYSTEM_PACKET_HANDLER);
   telecommandPacketDispatcher =
     ESAT_CCSDSTelecommandPacketDispatcher(applicationProcessIdentifier);
   telemetryPacketBuilder =
@@ -49,9 +52,28 @@ void ESAT_SubsystemPacketHandlerClass::begin(const word applicationProcessIdenti
                                      patchVersionNumber,
                                      clock);
   telemetryClock = &clock;
-  usbReader = ESAT_CCSDSPacketFromKISSFrameReader(Serial,
-                                                  packetDataCapacity
-                                                  + ESAT_CCSDSPrimaryHeader::LENGTH);
+  if (usbInputFrames == 0)
+  {
+    usbReader = ESAT_CCSDSPacketFromKISSFrameReader(Serial,
+                                                    packetDataCapacity
+                                                    + ESAT_CCSDSPrimaryHeader::LENGTH);
+  }
+  else
+  {
+    // Frames are as long as the frame buffer of the reader at most.
+    // Frames are never split at the end of the arena, so a frame that
+    // doesn't fit there leaves up to a frame length unused until the
+    // ring wraps around; one more frame length of arena guarantees
+    // room for usbInputFrames frames even then.
+    const unsigned long maximumFrameLength =
+      packetDataCapacity + ESAT_CCSDSPrimaryHeader::LENGTH;
+    usbInputFrameQueue =
+      ESAT_KISSFrameQueue((usbInputFrames + 1) * maximumFrameLength,
+                          usbInputFrames);
+    usbReader = ESAT_CCSDSPacketFromKISSFrameReader(Serial,
+                                                    maximumFrameLength,
+                                                    usbInputFrameQueue);
+  }
   usbWriter = ESAT_CCSDSPacketToKISSFrameWriter(Serial);
   ESAT_I2CSlave.begin(i2cInterface,
                       packetDataCapacity,
@@ -94,7 +116,7 @@ void ESAT_SubsystemPacketHandlerClass::prepareSubsystemsOwnTelemetry()
   pendingI2CTelemetryBuffer = pendingI2CTelemetryBuffer | pendingTelemetry;
 }
 
-boolean ESAT_SubsystemPacketHandlerClass::queueTelecommandToI2C(ESAT_CCSDSPacket telecommandPacket)
+boolean ESAT_SubsystemPacketHandlerClass::queueTelecommandToI2C(const ESAT_CCSDSPacket& telecommandPacket)
 {
   if (i2cTelecommandPacket.packetDataLength() == 0)
   {
@@ -219,7 +241,7 @@ void ESAT_SubsystemPacketHandlerClass::setTime(ESAT_Timestamp timestamp)
   }
 }
 
-void ESAT_SubsystemPacketHandlerClass::writePacketToUSB(ESAT_CCSDSPacket packet)
+void ESAT_SubsystemPacketHandlerClass::writePacketToUSB(const ESAT_CCSDSPacket& packet)
 {
   (void) usbWriter.unbufferedWrite(packet);
 }
@@ -60,6 +60,9 @@ class ESAT_SubsystemPacketHandlerClass
     // started, but the subsystem data handler will start the
     // CCSDS-over-I2C slave protocol (call ESAT_I2CSlave.begin()).
     // Work with packets of the given packet data capacity.
+    // Queue up to the given number of incoming USB frames (none by
+    // default), so that bursts of packets coming from the USB
+    // interface aren't lost while they are read one by one.
     void begin(word applicationProcessIdentifier,
                byte majorVersionNumber,
                byte minorVersionNumber,
@@ -67,7 +70,8 @@ class ESAT_SubsystemPacketHandlerClass
                ESAT_Clock& clock,
                TwoWire& i2cInterface,
                unsigned long packetDataCapacity,
-               unsigned long i2cInputPacketBufferCapacity);
+               unsigned long i2cInputPacketBufferCapacity,
+               byte usbInputFrames = 0);
 
     // Disable the telemetry packet with the given identifier.
     void disableTelemetry(byte packetIdentifier);
@@ -89,7 +93,7 @@ class ESAT_SubsystemPacketHandlerClass
     // Queue a telecommand packet so that the I2C bus master can
     // request it later.
     // Return true on success; otherwise (on a full queue) return false.
-    boolean queueTelecommandToI2C(ESAT_CCSDSPacket telecommandPacket);
+    boolean queueTelecommandToI2C(const ESAT_CCSDSPacket& telecommandPacket);
 
     // Read a packet from the I2C interface.
     // Return true on success; otherwise return false.
@@ -112,7 +116,7 @@ class ESAT_SubsystemPacketHandlerClass
     void setTime(ESAT_Timestamp timestamp);
 
     // Write a packet to the USB interface.
-    void writePacketToUSB(ESAT_CCSDSPacket packet);
+    void writePacketToUSB(const ESAT_CCSDSPacket& packet);
 
   private:
     // Enabled telemetry list.
@@ -144,6 +148,9 @@ class ESAT_SubsystemPacketHandlerClass
     // Telemetry packet builder.
     ESAT_CCSDSTelemetryPacketBuilder telemetryPacketBuilder;
 
+    // Queue of KISS frames coming from the USB interface.
+    ESAT_KISSFrameQueue usbInputFrameQueue;
+
     // Use this to read CCSDS packet from KISS frames coming from the
     // USB interface.
     ESAT_CCSDSPacketFromKISSFrameReader usbReader;
@@ -280,6 +280,28 @@ size_t ESAT_Timestamp::printTo(Print& output) const
   return bytesWritten;
 }
 
+void ESAT_Timestamp::readFrom(const byte octets[])
+{
+  year = ESAT_Util.decodeBinaryCodedDecimalWord(word(octets[0], octets[1]));
+  month = ESAT_Util.decodeBinaryCodedDecimalByte(octets[2]);
+  day = ESAT_Util.decodeBinaryCodedDecimalByte(octets[3]);
+  hours = ESAT_Util.decodeBinaryCodedDecimalByte(octets[4]);
+  minutes = ESAT_Util.decodeBinaryCodedDecimalByte(octets[5]);
+  seconds = ESAT_Util.decodeBinaryCodedDecimalByte(octets[6]);
+}
+
+void ESAT_Timestamp::writeTo(byte octets[]) const
+{
+  const word encodedYear = ESAT_Util.encodeBinaryCodedDecimalWord(year);
+  octets[0] = highByte(encodedYear);
+  octets[1] = lowByte(encodedYear);
+  octets[2] = ESAT_Util.encodeBinaryCodedDecimalByte(month);
+  octets[3] = ESAT_Util.encodeBinaryCodedDecimalByte(day);
+  octets[4] = ESAT_Util.encodeBinaryCodedDecimalByte(hours);
+  octets[5] = ESAT_Util.encodeBinaryCodedDecimalByte(minutes);
+  octets[6] = ESAT_Util.encodeBinaryCodedDecimalByte(seconds);
+}
+
 boolean ESAT_Timestamp::operator==(const ESAT_Timestamp timestamp) const
 {
   const ComparisonResult result = compareTo(timestamp);
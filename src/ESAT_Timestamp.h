@@ -29,6 +29,10 @@
 class ESAT_Timestamp: public Printable
 {
   public:
+    // Number of bytes of a timestamp in binary coded decimal form
+    // (as found in the secondary header of packets).
+    static const byte LENGTH = 7;
+
     // Year (from 1 to 9999).
     word year;
 
@@ -92,6 +96,15 @@ class ESAT_Timestamp: public Printable
     // Return the number of characters written.
     size_t printTo(Print& output) const;
 
+    // Set the fields of the timestamp from an array of LENGTH bytes
+    // with the timestamp in binary coded decimal form: year (2 bytes),
+    // month, day, hours, minutes and seconds (1 byte each).
+    void readFrom(const byte octets[]);
+
+    // Write the timestamp in binary coded decimal form to an array
+    // of LENGTH bytes (see readFrom()).
+    void writeTo(byte octets[]) const;
+
     // Return true if the argument timestamp coincides with this timestamp;
     // otherwise return false.
     boolean operator==(ESAT_Timestamp timestamp) const;